@@ -11,15 +11,13 @@ current_dir = os.path.dirname(os.path.abspath(__file__))
 @app.route('/process_text', methods=['POST'])
 def process_text():
     input_text = request.json.get('inputText')
-    
-    cnf_file_path = os.path.join(current_dir, 'temp.cnf')
-    with open('temp.cnf', 'w') as cnf_file:
-        cnf_file.write(input_text)
 
     solver_executable = os.path.join(current_dir, '..', 'cpp', 'build', 'LTLSolver')
 
-    command = [solver_executable, cnf_file_path]
-    result = subprocess.run(command, capture_output=True, text=True)
+    # The formula is streamed to the solver's stdin, so concurrent requests
+    # never share a file on disk
+    command = [solver_executable, '-']
+    result = subprocess.run(command, input=input_text, capture_output=True, text=True)
 
     if result.returncode == 0 and result.stdout.strip() == "SAT":
         output_text = "Satisfiable"
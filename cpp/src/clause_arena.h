@@ -0,0 +1,482 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/*
+ * A reference to a clause in a ClauseArena: the offset of its header,
+ * counted in 32-bit words from the start of the arena
+ */
+
+typedef uint32_t ClauseRef;
+
+const ClauseRef CLAUSE_UNDEF = UINT32_MAX;
+
+/*
+ * The tiers of learned clauses
+ *   core: kept forever
+ *   tier2: kept while they keep taking part in conflicts
+ *   local: the worse half is deleted at every reduction
+ */
+
+enum ClauseTier
+{
+    core,
+    tier2,
+    local
+};
+
+/*
+ * A clause stored inline in a ClauseArena
+ *
+ * The literals follow the three-word header directly in memory, so a
+ * Clause must only be accessed through a reference into its arena.
+ *
+ * Member functions:
+ *   int size()
+ *       Gets the number of literals
+ *       @return The number of literals
+ *
+ *   int *literals()
+ *       Gets the literals stored after the header
+ *       @return A pointer to the first literal
+ *
+ *   int &operator[](int i)
+ *       Gets the i-th literal
+ *       @param i The position of the literal
+ *       @return The literal
+ *
+ *   void shrink(int new_size)
+ *       Drops the literals past the given size
+ *       @param new_size The new number of literals
+ *
+ * Data members:
+ *   uint32_t literal_count
+ *       The number of literals
+ *
+ *   uint32_t learnt
+ *       1 if the clause was learned from a conflict
+ *
+ *   uint32_t deleted
+ *       1 if the clause has been freed
+ *
+ *   uint32_t relocated
+ *       1 if the clause has been moved by the garbage collector; its new
+ *       reference is stored in place of its first literal
+ *
+ *   uint32_t used
+ *       1 if the learned clause took part in a conflict since the last
+ *       reduction of the clause database
+ *
+ *   uint32_t tier
+ *       The tier of a learned clause (see ClauseTier)
+ *
+ *   uint32_t vivified
+ *       1 if the clause has already been vivified
+ *
+ *   uint32_t imported
+ *       1 if the learned clause was received from another solver and has
+ *       not taken part in a conflict yet
+ *
+ *   uint32_t lbd
+ *       The literal block distance of a learned clause
+ *
+ *   float activity
+ *       The activity of a learned clause
+ *
+ *   uint32_t base_index
+ *       The position of a clause of a base arena among the clauses of that
+ *       arena, which indexes the states kept for it (see ClauseArena); base
+ *       clauses are never learned, so it takes the place of the activity
+ */
+
+struct Clause
+{
+    uint32_t literal_count;
+    uint32_t learnt : 1;
+    uint32_t deleted : 1;
+    uint32_t relocated : 1;
+    uint32_t used : 1;
+    uint32_t tier : 2;
+    uint32_t vivified : 1;
+    uint32_t imported : 1;
+    uint32_t lbd : 24;
+    union
+    {
+        float activity;
+        uint32_t base_index;
+    };
+
+    int size()
+    {
+        return literal_count;
+    }
+
+    int *literals()
+    {
+        return reinterpret_cast<int *>(this + 1);
+    }
+
+    int &operator[](int i)
+    {
+        return literals()[i];
+    }
+
+    void shrink(int new_size)
+    {
+        literal_count = new_size;
+    }
+};
+
+/*
+ * What a solver keeps of its own for a clause of a base arena
+ *
+ * A base clause is only read, so the solver cannot move its watched
+ * literals to the front or mark it in its header; it keeps their positions
+ * and its marks here instead.
+ *
+ * Data members:
+ *   uint32_t first_watch, second_watch
+ *       The positions of the two watched literals of a clause of more than
+ *       three literals, the one a propagation implies first
+ *
+ *   uint32_t deleted
+ *       1 if the solver has freed the clause
+ *
+ *   uint32_t vivified
+ *       1 if the solver has already vivified the clause
+ */
+
+struct BaseClauseState
+{
+    uint32_t first_watch : 31;
+    uint32_t deleted : 1;
+    uint32_t second_watch : 31;
+    uint32_t vivified : 1;
+};
+
+/*
+ * A contiguous arena of clauses addressed by 32-bit references
+ *
+ * Allocating may move the arena, so Clause references obtained from
+ * operator[] must not be held across a call to allocate(). The arena holds
+ * at most CLAUSE_ARENA_CAPACITY words; allocating past it throws
+ * std::length_error rather than handing out a reference that would be
+ * mistaken for a binary reason.
+ *
+ * Several solvers can read the same original clauses from a base arena
+ * instead of each keeping a copy. The references below the size of the
+ * base arena address its clauses, and the clauses allocated afterwards
+ * follow them. Base clauses must never be written: free() and the other
+ * marks go to a BaseClauseState of this arena, so the deleted and vivified
+ * bits of a clause are read through deleted() and vivified(), and a base
+ * clause that changes is replaced by a copy of its own. The base arena
+ * itself never moves or grows, so references into it stay valid across
+ * allocate().
+ *
+ * Member functions:
+ *   ClauseRef allocate(const int *literals, int size, bool learnt)
+ *       Stores a new clause at the end of the arena
+ *       @param literals The literals of the clause
+ *       @param size The number of literals
+ *       @param learnt Whether the clause is learned
+ *       @return The reference of the new clause
+ *       @throws std::length_error if the arena would outgrow
+ *               CLAUSE_ARENA_CAPACITY
+ *
+ *   Clause &operator[](ClauseRef ref)
+ *       Gets the clause with the given reference
+ *       @param ref The reference
+ *       @return The clause
+ *
+ *   void free(ClauseRef ref)
+ *       Marks the clause as deleted and counts its memory as wasted; the
+ *       memory of a base clause is not this arena's to reclaim
+ *       @param ref The reference
+ *
+ *   bool deleted(ClauseRef ref)
+ *       Checks whether the clause has been freed
+ *       @param ref The reference
+ *       @return true if the clause is deleted
+ *
+ *   bool vivified(ClauseRef ref)
+ *       Checks whether the clause has been vivified
+ *       @param ref The reference
+ *       @return true if the clause is vivified
+ *
+ *   void markVivified(ClauseRef ref)
+ *       Marks the clause as vivified
+ *       @param ref The reference
+ *
+ *   bool inBase(ClauseRef ref)
+ *       Checks whether the clause belongs to the base arena
+ *       @param ref The reference
+ *       @return true if the clause must not be written
+ *
+ *   BaseClauseState &baseState(ClauseRef ref)
+ *       Gets the state kept for a clause of the base arena
+ *       @param ref The reference of a base clause
+ *       @return The state
+ *
+ *   void setBase(std::shared_ptr<ClauseArena> base, int clause_count)
+ *       Makes the clauses of an arena that is no longer written the first
+ *       clauses of this one, which must be empty
+ *       @param base The base arena
+ *       @param clause_count The number of clauses of the base arena, each
+ *                           numbered by its base_index
+ *
+ *   void shareBase(ClauseArena &other)
+ *       Reads the base arena of another arena, with states of its own
+ *       @param other The arena whose base is shared
+ *
+ *   void relocate(ClauseRef &ref, ClauseArena &to)
+ *       Moves the clause into the given arena the first time it is seen,
+ *       then updates the reference to its new location; a deleted clause
+ *       stays deleted and a base clause stays where it is
+ *       @param ref The reference, updated in place
+ *       @param to The arena being compacted into, without a base arena;
+ *                 its clauses are addressed after the base of this one
+ *
+ *   size_t size()
+ *       Gets the number of words in use, including wasted ones, without
+ *       the base arena
+ *
+ *   size_t wasted()
+ *       Gets the number of words taken by deleted clauses
+ *
+ *   void reserve(size_t words)
+ *       Reserves memory for the given number of words
+ *
+ *   void swap(ClauseArena &other)
+ *       Exchanges the clauses of their own of two arenas; the base arena
+ *       and its states stay in place
+ *
+ * Data members:
+ *   std::vector<uint32_t> memory
+ *       The clause headers and literals
+ *
+ *   size_t wasted_words
+ *       The number of words taken by deleted clauses
+ *
+ *   std::shared_ptr<ClauseArena> base
+ *       The arena of the clauses read by several solvers, nullptr if none
+ *
+ *   uint32_t *base_memory
+ *       The memory of the base arena
+ *
+ *   ClauseRef base_words
+ *       The number of words of the base arena, which is also the reference
+ *       of the first clause of this arena
+ *
+ *   std::vector<BaseClauseState> base_states
+ *       The state of each base clause, indexed by its base_index
+ */
+
+class ClauseArena
+{
+private:
+    // Data members
+    std::vector<uint32_t> memory;
+    size_t wasted_words;
+    std::shared_ptr<ClauseArena> base;
+    uint32_t *base_memory;
+    ClauseRef base_words;
+    std::vector<BaseClauseState> base_states;
+
+public:
+    // Constructors
+    ClauseArena();
+
+    // Member functions
+    ClauseRef allocate(const int *, int, bool);
+    Clause &operator[](ClauseRef);
+    void free(ClauseRef);
+    bool deleted(ClauseRef);
+    bool vivified(ClauseRef);
+    void markVivified(ClauseRef);
+    bool inBase(ClauseRef);
+    BaseClauseState &baseState(ClauseRef);
+    void setBase(std::shared_ptr<ClauseArena>, int);
+    void shareBase(ClauseArena &);
+    void relocate(ClauseRef &, ClauseArena &);
+    size_t size();
+    size_t wasted();
+    void reserve(size_t);
+    void swap(ClauseArena &);
+};
+
+// The number of words taken by a clause header
+const int CLAUSE_HEADER_WORDS = sizeof(Clause) / sizeof(uint32_t);
+
+// The largest number of words in an arena: the highest bit of a reference
+// tags binary reasons (see BINARY_REASON)
+const size_t CLAUSE_ARENA_CAPACITY = (size_t)1 << 31;
+
+ClauseArena::ClauseArena()
+{
+    wasted_words = 0;
+    base_memory = nullptr;
+    base_words = 0;
+}
+
+ClauseRef ClauseArena::allocate(const int *literals, int size, bool learnt)
+{
+    if (base_words + memory.size() + CLAUSE_HEADER_WORDS + size > CLAUSE_ARENA_CAPACITY)
+    {
+        throw std::length_error("the clause arena is full");
+    }
+
+    ClauseRef ref = base_words + memory.size();
+    memory.resize(memory.size() + CLAUSE_HEADER_WORDS + size);
+
+    Clause &clause = (*this)[ref];
+    clause.literal_count = size;
+    clause.learnt = learnt;
+    clause.deleted = 0;
+    clause.relocated = 0;
+    clause.used = 0;
+    clause.tier = 0;
+    clause.vivified = 0;
+    clause.imported = 0;
+    clause.lbd = 0;
+    clause.activity = 0;
+
+    for (int i = 0; i < size; i++)
+    {
+        clause[i] = literals[i];
+    }
+
+    return ref;
+}
+
+Clause &ClauseArena::operator[](ClauseRef ref)
+{
+    if (ref < base_words)
+    {
+        return *reinterpret_cast<Clause *>(&base_memory[ref]);
+    }
+    return *reinterpret_cast<Clause *>(&memory[ref - base_words]);
+}
+
+void ClauseArena::free(ClauseRef ref)
+{
+    if (ref < base_words)
+    {
+        ClauseArena::baseState(ref).deleted = 1;
+        return;
+    }
+
+    Clause &clause = (*this)[ref];
+    if (!clause.deleted)
+    {
+        clause.deleted = 1;
+        wasted_words += CLAUSE_HEADER_WORDS + clause.size();
+    }
+}
+
+bool ClauseArena::deleted(ClauseRef ref)
+{
+    return ref < base_words ? ClauseArena::baseState(ref).deleted : (*this)[ref].deleted;
+}
+
+bool ClauseArena::vivified(ClauseRef ref)
+{
+    return ref < base_words ? ClauseArena::baseState(ref).vivified : (*this)[ref].vivified;
+}
+
+void ClauseArena::markVivified(ClauseRef ref)
+{
+    if (ref < base_words)
+    {
+        ClauseArena::baseState(ref).vivified = 1;
+    }
+    else
+    {
+        (*this)[ref].vivified = 1;
+    }
+}
+
+bool ClauseArena::inBase(ClauseRef ref)
+{
+    return ref < base_words;
+}
+
+BaseClauseState &ClauseArena::baseState(ClauseRef ref)
+{
+    return base_states[(*this)[ref].base_index];
+}
+
+void ClauseArena::setBase(std::shared_ptr<ClauseArena> base, int clause_count)
+{
+    this->base = base;
+    base_memory = base->memory.data();
+    base_words = base->memory.size();
+    base_states.assign(clause_count, {0, 0, 1, 0});
+}
+
+void ClauseArena::shareBase(ClauseArena &other)
+{
+    ClauseArena::setBase(other.base, other.base_states.size());
+}
+
+void ClauseArena::relocate(ClauseRef &ref, ClauseArena &to)
+{
+    // Base clauses never move
+    if (ref < base_words)
+    {
+        return;
+    }
+
+    Clause &clause = (*this)[ref];
+
+    // If the clause has already been moved, follow its forwarding reference
+    if (clause.relocated)
+    {
+        ref = clause[0];
+        return;
+    }
+
+    ClauseRef new_ref = to.allocate(clause.literals(), clause.size(), clause.learnt);
+    Clause &moved = to[new_ref];
+    moved.used = clause.used;
+    moved.tier = clause.tier;
+    moved.vivified = clause.vivified;
+    moved.imported = clause.imported;
+    moved.lbd = clause.lbd;
+    moved.activity = clause.activity;
+    if (clause.deleted)
+    {
+        to.free(new_ref);
+    }
+
+    // Leave a forwarding reference behind for the other references to the
+    // clause, which follow the base arena like the clauses they replace
+    new_ref += base_words;
+    clause.relocated = 1;
+    clause[0] = new_ref;
+    ref = new_ref;
+}
+
+size_t ClauseArena::size()
+{
+    return memory.size();
+}
+
+size_t ClauseArena::wasted()
+{
+    return wasted_words;
+}
+
+void ClauseArena::reserve(size_t words)
+{
+    memory.reserve(words);
+}
+
+void ClauseArena::swap(ClauseArena &other)
+{
+    memory.swap(other.memory);
+    std::swap(wasted_words, other.wasted_words);
+}
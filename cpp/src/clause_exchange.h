@@ -0,0 +1,235 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/*
+ * The largest clause a ClauseExchange can carry
+ */
+
+const int SHARED_CLAUSE_SIZE = 32;
+
+/*
+ * A slot of a ClauseRing, holding one shared clause
+ *
+ * The slot is a sequence lock: the sequence number is odd while the
+ * producer writes the clause and becomes 2 * (n + 1) once the n-th clause
+ * of the ring is complete. A reader copies the clause and keeps it only if
+ * the sequence number was that value both before and after the copy.
+ * Every field is atomic so that a read racing with a write is not a data
+ * race, only a copy that gets thrown away.
+ *
+ * Data members:
+ *   std::atomic<uint64_t> sequence
+ *       The sequence number
+ *
+ *   std::atomic<int> size
+ *       The number of literals
+ *
+ *   std::atomic<int> lbd
+ *       The literal block distance of the clause in its producer
+ *
+ *   std::atomic<int> literals[SHARED_CLAUSE_SIZE]
+ *       The literals
+ */
+
+struct SharedClause
+{
+    std::atomic<uint64_t> sequence{0};
+    std::atomic<int> size{0};
+    std::atomic<int> lbd{0};
+    std::atomic<int> literals[SHARED_CLAUSE_SIZE];
+};
+
+/*
+ * The clauses exported by one solver, in a ring of slots overwritten
+ * oldest first
+ *
+ * Data members:
+ *   std::unique_ptr<SharedClause[]> slots
+ *       The slots, the n-th clause going to slot n modulo their number
+ *
+ *   std::atomic<uint64_t> head
+ *       The number of clauses published so far; on its own cache line, as
+ *       every reader polls it
+ */
+
+struct ClauseRing
+{
+    std::unique_ptr<SharedClause[]> slots;
+    alignas(64) std::atomic<uint64_t> head{0};
+};
+
+/*
+ * Lock-free exchange of learned clauses between the solvers of a portfolio
+ *
+ * Each solver publishes to its own ring and reads the rings of the others,
+ * so every ring has a single producer and many consumers. Nobody waits: a
+ * producer overwrites the oldest clauses of its ring, and a consumer that
+ * falls too far behind loses them.
+ *
+ * Member functions:
+ *   void publish(int worker, const int *literals, int size, int lbd)
+ *       Publishes a clause to the ring of a solver; only that solver may
+ *       call it
+ *       @param worker The index of the solver
+ *       @param literals The literals, at most SHARED_CLAUSE_SIZE
+ *       @param size The number of literals
+ *       @param lbd The literal block distance of the clause
+ *
+ *   bool pending(int worker)
+ *       Checks whether the other solvers published clauses that a solver
+ *       has not collected yet
+ *       @param worker The index of the solver
+ *       @return true if there are new clauses
+ *
+ *   long long collect(int worker, std::vector<int> &shared)
+ *       Appends the new clauses of the other solvers, each as its size, its
+ *       LBD and its literals; only the given solver may call it
+ *       @param worker The index of the solver
+ *       @param shared The clauses, appended to
+ *       @return The number of clauses overwritten before they were read
+ *
+ * Data members:
+ *   int worker_count
+ *       The number of solvers
+ *
+ *   uint64_t capacity
+ *       The number of slots of each ring, a power of 2
+ *
+ *   std::vector<std::unique_ptr<ClauseRing>> rings
+ *       The ring of each solver
+ *
+ *   std::vector<std::vector<uint64_t>> cursors
+ *       The number of clauses each solver has read from the ring of each
+ *       other solver, indexed by reader and then by producer
+ */
+
+class ClauseExchange
+{
+private:
+    // Data members
+    int worker_count;
+    uint64_t capacity;
+    std::vector<std::unique_ptr<ClauseRing>> rings;
+    std::vector<std::vector<uint64_t>> cursors;
+
+public:
+    // Constructors
+    ClauseExchange(int, int);
+
+    // Member functions
+    void publish(int, const int *, int, int);
+    bool pending(int);
+    long long collect(int, std::vector<int> &);
+};
+
+ClauseExchange::ClauseExchange(int worker_count, int capacity)
+{
+    this->worker_count = worker_count;
+
+    // Round the capacity up to a power of 2 so that slots are found by masking
+    this->capacity = 1;
+    while (this->capacity < (uint64_t)capacity)
+    {
+        this->capacity *= 2;
+    }
+
+    for (int worker = 0; worker < worker_count; worker++)
+    {
+        rings.emplace_back(new ClauseRing());
+        rings.back()->slots.reset(new SharedClause[this->capacity]);
+    }
+    cursors.assign(worker_count, std::vector<uint64_t>(worker_count, 0));
+}
+
+void ClauseExchange::publish(int worker, const int *literals, int size, int lbd)
+{
+    ClauseRing &ring = *rings[worker];
+    uint64_t index = ring.head.load(std::memory_order_relaxed);
+    SharedClause &slot = ring.slots[index & (capacity - 1)];
+
+    // Mark the slot as being written before touching the clause
+    slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.size.store(size, std::memory_order_relaxed);
+    slot.lbd.store(lbd, std::memory_order_relaxed);
+    for (int i = 0; i < size; i++)
+    {
+        slot.literals[i].store(literals[i], std::memory_order_relaxed);
+    }
+
+    // Publish the complete clause
+    slot.sequence.store(2 * index + 2, std::memory_order_release);
+    ring.head.store(index + 1, std::memory_order_release);
+}
+
+bool ClauseExchange::pending(int worker)
+{
+    for (int producer = 0; producer < worker_count; producer++)
+    {
+        if (producer != worker && rings[producer]->head.load(std::memory_order_relaxed) != cursors[worker][producer])
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+long long ClauseExchange::collect(int worker, std::vector<int> &shared)
+{
+    long long lost = 0;
+    for (int producer = 0; producer < worker_count; producer++)
+    {
+        if (producer == worker)
+        {
+            continue;
+        }
+
+        ClauseRing &ring = *rings[producer];
+        uint64_t &cursor = cursors[worker][producer];
+        uint64_t head = ring.head.load(std::memory_order_acquire);
+
+        // The clauses older than a full ring have been overwritten already
+        if (head - cursor > capacity)
+        {
+            lost += head - capacity - cursor;
+            cursor = head - capacity;
+        }
+
+        for (; cursor < head; cursor++)
+        {
+            SharedClause &slot = ring.slots[cursor & (capacity - 1)];
+            uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence != 2 * cursor + 2)
+            {
+                lost++;
+                continue;
+            }
+
+            // Copy the clause, then check that the producer did not
+            // overwrite it meanwhile
+            int start = shared.size();
+            int size = slot.size.load(std::memory_order_relaxed);
+            shared.push_back(size);
+            shared.push_back(slot.lbd.load(std::memory_order_relaxed));
+            for (int i = 0; i < size; i++)
+            {
+                shared.push_back(slot.literals[i].load(std::memory_order_relaxed));
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) != sequence)
+            {
+                shared.resize(start);
+                lost++;
+            }
+        }
+    }
+
+    return lost;
+}
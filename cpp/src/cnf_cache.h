@@ -0,0 +1,533 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "sat_solver.h"
+
+/*
+ * The binary CNF cache format
+ *
+ * A cache file is a CNFCacheHeader followed by the clause stream. Each
+ * clause is its size followed by its literal codes (2 * variable, plus 1
+ * for negative literals) in increasing order, the first one as is and the
+ * others as the difference with the previous one. Every number is an
+ * unsigned LEB128 varint, so most literals take one or two bytes.
+ *
+ * The header is written in the byte order of the machine, so a cache is
+ * only read back on machines with the same byte order; the version check
+ * rejects the others.
+ *
+ * Data members:
+ *   char magic[8]
+ *       CNF_CACHE_MAGIC
+ *
+ *   uint32_t version
+ *       CNF_CACHE_VERSION
+ *
+ *   uint32_t variable_count
+ *       The number of variables
+ *
+ *   uint64_t clause_count, literal_count
+ *       The numbers of clauses and literals in the stream
+ *
+ *   uint64_t payload_size
+ *       The number of bytes of the clause stream
+ *
+ *   uint64_t source_size
+ *   int64_t source_mtime
+ *       The size and modification time of the DIMACS file the cache was
+ *       made from, to tell whether the cache is stale
+ *
+ *   uint64_t checksum
+ *       The cacheChecksum of the clause stream
+ */
+
+struct CNFCacheHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t variable_count;
+    uint64_t clause_count;
+    uint64_t literal_count;
+    uint64_t payload_size;
+    uint64_t source_size;
+    int64_t source_mtime;
+    uint64_t checksum;
+};
+
+const char CNF_CACHE_MAGIC[8] = {'L', 'T', 'L', 'C', 'N', 'F', '\x01', '\x02'};
+
+const uint32_t CNF_CACHE_VERSION = 1;
+
+/*
+ * Extends a checksum over a block of bytes
+ *
+ * Whole 8-byte words are mixed at a time, so every block except the last
+ * one must have a size that is a multiple of 8.
+ *
+ * @param hash The checksum of the previous blocks, 0 for the first one
+ * @param data The block
+ * @param size The number of bytes in the block
+ * @return The checksum of all the blocks so far
+ */
+
+uint64_t cacheChecksum(uint64_t hash, const uint8_t *data, size_t size)
+{
+    const uint64_t prime = 0x100000001b3ull;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8)
+    {
+        uint64_t word;
+        memcpy(&word, data + i, 8);
+        hash = (hash ^ word) * prime;
+        hash ^= hash >> 29;
+    }
+    for (; i < size; i++)
+    {
+        hash = (hash ^ data[i]) * prime;
+    }
+    return hash;
+}
+
+/*
+ * Writes a CNF cache file clause by clause
+ *
+ * The clause stream is buffered and written in blocks, then the header is
+ * written over a placeholder at the start. The file is written under a
+ * temporary name and renamed when complete, so a cache is never half
+ * written.
+ *
+ * Member functions:
+ *   bool open(const std::string &path, const std::string &source_path)
+ *       Starts a cache file
+ *       @param path The path of the cache file
+ *       @param source_path The DIMACS file the cache is made from
+ *       @return false if the file cannot be created
+ *
+ *   void addClause(const int *literals, int size)
+ *       Appends a clause to the stream
+ *       @param literals The literals of the clause
+ *       @param size The number of literals
+ *
+ *   bool close(int variable_count)
+ *       Writes the header and moves the file to its path
+ *       @param variable_count The number of variables of the formula
+ *       @return false if the file cannot be written
+ *
+ *   void putVarint(uint64_t value)
+ *       Appends an unsigned LEB128 varint to the buffer
+ *       @param value The number
+ *
+ *   bool flush(bool last)
+ *       Writes the buffer, keeping back a tail shorter than 8 bytes
+ *       unless it is the last block
+ *       @param last Whether no more clauses follow
+ *       @return false if the file cannot be written
+ *
+ * Data members:
+ *   FILE *file
+ *       The temporary file being written
+ *
+ *   std::string path, temporary_path
+ *       The final and the temporary paths of the file
+ *
+ *   CNFCacheHeader header
+ *       The header being filled
+ *
+ *   std::vector<uint8_t> buffer
+ *       The part of the stream not written yet
+ *
+ *   std::vector<uint32_t> codes
+ *       The sorted literal codes of the clause being added
+ *
+ *   bool write_failed
+ *       Whether a write has failed
+ */
+
+class CNFCacheWriter
+{
+private:
+    // Member functions
+    void putVarint(uint64_t);
+    bool flush(bool);
+
+    // Data members
+    FILE *file;
+    std::string path;
+    std::string temporary_path;
+    CNFCacheHeader header;
+    std::vector<uint8_t> buffer;
+    std::vector<uint32_t> codes;
+    bool write_failed;
+
+public:
+    // Constructors
+    CNFCacheWriter();
+    ~CNFCacheWriter();
+
+    // Member functions
+    bool open(const std::string &, const std::string &);
+    void addClause(const int *, int);
+    bool close(int);
+};
+
+// The size of the blocks of the clause stream written at once
+const size_t CNF_CACHE_BLOCK_SIZE = 1 << 20;
+
+CNFCacheWriter::CNFCacheWriter()
+{
+    this->file = nullptr;
+    this->write_failed = false;
+    memset(&header, 0, sizeof(header));
+}
+
+CNFCacheWriter::~CNFCacheWriter()
+{
+    // A cache that was not closed is incomplete, so it is thrown away
+    if (file != nullptr)
+    {
+        fclose(file);
+        unlink(temporary_path.c_str());
+    }
+}
+
+bool CNFCacheWriter::open(const std::string &path, const std::string &source_path)
+{
+    this->path = path;
+    this->temporary_path = path + ".tmp";
+    file = fopen(temporary_path.c_str(), "wb");
+    if (file == nullptr)
+    {
+        std::cerr << "Error: cannot create " << temporary_path << ".\n";
+        return false;
+    }
+
+    memcpy(header.magic, CNF_CACHE_MAGIC, sizeof(header.magic));
+    header.version = CNF_CACHE_VERSION;
+
+    struct stat source_stat;
+    if (stat(source_path.c_str(), &source_stat) == 0)
+    {
+        header.source_size = source_stat.st_size;
+        header.source_mtime = source_stat.st_mtime;
+    }
+
+    // Leave room for the header, which is only known at the end
+    write_failed = fwrite(&header, sizeof(header), 1, file) != 1;
+    buffer.reserve(CNF_CACHE_BLOCK_SIZE + 16);
+    return !write_failed;
+}
+
+void CNFCacheWriter::putVarint(uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        buffer.push_back(value | 0x80);
+        value >>= 7;
+    }
+    buffer.push_back(value);
+}
+
+void CNFCacheWriter::addClause(const int *literals, int size)
+{
+    codes.clear();
+    for (int i = 0; i < size; i++)
+    {
+        int literal = literals[i];
+        codes.push_back(literal > 0 ? 2 * (uint32_t)literal : 2 * (uint32_t)(-literal) + 1);
+    }
+    std::sort(codes.begin(), codes.end());
+
+    // Sorted codes only grow, so the differences are small and positive
+    CNFCacheWriter::putVarint(size);
+    uint32_t previous = 0;
+    for (uint32_t code : codes)
+    {
+        CNFCacheWriter::putVarint(code - previous);
+        previous = code;
+    }
+
+    header.clause_count++;
+    header.literal_count += size;
+    if (buffer.size() >= CNF_CACHE_BLOCK_SIZE)
+    {
+        CNFCacheWriter::flush(false);
+    }
+}
+
+bool CNFCacheWriter::flush(bool last)
+{
+    // Blocks other than the last one are whole words for the checksum
+    size_t size = last ? buffer.size() : buffer.size() & ~(size_t)7;
+    header.checksum = cacheChecksum(header.checksum, buffer.data(), size);
+    header.payload_size += size;
+    if (size > 0 && fwrite(buffer.data(), 1, size, file) != size)
+    {
+        write_failed = true;
+    }
+    buffer.erase(buffer.begin(), buffer.begin() + size);
+    return !write_failed;
+}
+
+bool CNFCacheWriter::close(int variable_count)
+{
+    header.variable_count = variable_count;
+    CNFCacheWriter::flush(true);
+
+    // Replace the placeholder with the complete header
+    if (fseek(file, 0, SEEK_SET) != 0 || fwrite(&header, sizeof(header), 1, file) != 1)
+    {
+        write_failed = true;
+    }
+
+    bool closed = fclose(file) == 0;
+    file = nullptr;
+    if (write_failed || !closed || rename(temporary_path.c_str(), path.c_str()) != 0)
+    {
+        std::cerr << "Error: cannot write " << path << ".\n";
+        unlink(temporary_path.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+/*
+ * Loads a CNF cache file into a SATSolver
+ *
+ * The file is mapped into memory, checked against its header and checksum,
+ * then decoded straight into the solver.
+ *
+ * Member functions:
+ *   bool isCache(const std::string &path)
+ *       Checks whether a file starts with the cache magic bytes
+ *       @param path The path of the file
+ *       @return true if the file is a cache
+ *
+ *   bool isFresh(const std::string &path, const std::string &source_path)
+ *       Checks whether a cache was made from the current version of a file
+ *       @param path The path of the cache
+ *       @param source_path The path of the DIMACS file
+ *       @return true if the size and modification time of the DIMACS file
+ *               match the ones recorded in the cache
+ *
+ *   bool load(const std::string &path, SATSolver &solver)
+ *       Adds the clauses of a cache to a solver
+ *       @param path The path of the cache
+ *       @param solver The solver
+ *       @return false if the cache cannot be read or is corrupted
+ *
+ *   void printStatistics(std::ostream &out)
+ *       Prints the size of the cache and the load throughput as DIMACS
+ *       comments
+ *       @param out The stream to print to
+ *
+ *   bool decode(const uint8_t *data, const CNFCacheHeader &header, SATSolver &solver)
+ *       Decodes the clause stream into the solver
+ *       @param data The clause stream
+ *       @param header The header of the cache
+ *       @param solver The solver
+ *       @return false if the stream does not match the header
+ *
+ * Data members:
+ *   long long bytes
+ *       The size of the last cache loaded
+ *
+ *   long long clauses
+ *       The number of clauses loaded
+ *
+ *   double seconds
+ *       The time spent loading
+ */
+
+class CNFCacheReader
+{
+private:
+    // Member functions
+    bool decode(const uint8_t *, const CNFCacheHeader &, SATSolver &);
+
+    // Data members
+    long long bytes;
+    long long clauses;
+    double seconds;
+
+public:
+    // Constructors
+    CNFCacheReader();
+
+    // Member functions
+    static bool isCache(const std::string &);
+    static bool isFresh(const std::string &, const std::string &);
+    bool load(const std::string &, SATSolver &);
+    void printStatistics(std::ostream &);
+};
+
+CNFCacheReader::CNFCacheReader()
+{
+    this->bytes = 0;
+    this->clauses = 0;
+    this->seconds = 0;
+}
+
+bool CNFCacheReader::isCache(const std::string &path)
+{
+    char magic[sizeof(CNF_CACHE_MAGIC)];
+    FILE *file = fopen(path.c_str(), "rb");
+    if (file == nullptr)
+    {
+        return false;
+    }
+    bool matches = fread(magic, sizeof(magic), 1, file) == 1 && memcmp(magic, CNF_CACHE_MAGIC, sizeof(magic)) == 0;
+    fclose(file);
+    return matches;
+}
+
+bool CNFCacheReader::isFresh(const std::string &path, const std::string &source_path)
+{
+    CNFCacheHeader header;
+    FILE *file = fopen(path.c_str(), "rb");
+    if (file == nullptr)
+    {
+        return false;
+    }
+    bool read = fread(&header, sizeof(header), 1, file) == 1;
+    fclose(file);
+
+    struct stat source_stat;
+    return read && memcmp(header.magic, CNF_CACHE_MAGIC, sizeof(header.magic)) == 0 && header.version == CNF_CACHE_VERSION &&
+           stat(source_path.c_str(), &source_stat) == 0 && header.source_size == (uint64_t)source_stat.st_size && header.source_mtime == source_stat.st_mtime;
+}
+
+bool CNFCacheReader::load(const std::string &path, SATSolver &solver)
+{
+    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    struct stat file_stat;
+    if (fd < 0 || fstat(fd, &file_stat) != 0)
+    {
+        std::cerr << "Error: cannot open " << path << ".\n";
+        if (fd >= 0)
+        {
+            ::close(fd);
+        }
+        return false;
+    }
+
+    bytes = file_stat.st_size;
+    void *mapped = bytes >= (long long)sizeof(CNFCacheHeader) ? mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    ::close(fd);
+    if (mapped == MAP_FAILED)
+    {
+        std::cerr << "Error: cannot map " << path << ".\n";
+        return false;
+    }
+    madvise(mapped, bytes, MADV_SEQUENTIAL);
+
+    // Check the header and the checksum before touching the solver
+    CNFCacheHeader header;
+    memcpy(&header, mapped, sizeof(header));
+    const uint8_t *payload = static_cast<const uint8_t *>(mapped) + sizeof(header);
+    const char *problem = nullptr;
+    if (memcmp(header.magic, CNF_CACHE_MAGIC, sizeof(header.magic)) != 0)
+    {
+        problem = "not a CNF cache";
+    }
+    else if (header.version != CNF_CACHE_VERSION)
+    {
+        problem = "unsupported CNF cache version";
+    }
+    else if (header.payload_size != bytes - sizeof(header))
+    {
+        problem = "truncated CNF cache";
+    }
+    else if (cacheChecksum(0, payload, header.payload_size) != header.checksum)
+    {
+        problem = "CNF cache checksum mismatch";
+    }
+    else if (!CNFCacheReader::decode(payload, header, solver))
+    {
+        problem = "corrupted CNF cache";
+    }
+
+    munmap(mapped, bytes);
+    if (problem != nullptr)
+    {
+        std::cerr << "Error: " << path << ": " << problem << ".\n";
+        return false;
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+    seconds = elapsed.count();
+    return true;
+}
+
+bool CNFCacheReader::decode(const uint8_t *data, const CNFCacheHeader &header, SATSolver &solver)
+{
+    const uint8_t *end = data + header.payload_size;
+    uint64_t max_code = 2 * (uint64_t)header.variable_count + 1;
+    std::vector<int> clause;
+    solver.resizeVariables(header.variable_count);
+
+    // Reads one varint, failing at the end of the stream
+    auto next = [&](uint64_t &value)
+    {
+        value = 0;
+        for (int shift = 0; data < end && shift < 64; shift += 7)
+        {
+            uint8_t byte = *data++;
+            value |= (uint64_t)(byte & 0x7f) << shift;
+            if (byte < 0x80)
+            {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    clauses = 0;
+    while (data < end)
+    {
+        uint64_t size;
+        if (!next(size) || size > (uint64_t)(end - data))
+        {
+            return false;
+        }
+
+        clause.clear();
+        uint64_t code = 0;
+        for (uint64_t i = 0; i < size; i++)
+        {
+            uint64_t delta;
+            if (!next(delta) || (code += delta) > max_code || code < 2)
+            {
+                return false;
+            }
+            int variable = code >> 1;
+            clause.push_back(code & 1 ? -variable : variable);
+        }
+
+        solver.addClause(clause.data(), clause.size());
+        clauses++;
+    }
+
+    return clauses == (long long)header.clause_count;
+}
+
+void CNFCacheReader::printStatistics(std::ostream &out)
+{
+    double megabytes = bytes / 1e6;
+    out << "c cache bytes:               " << bytes << "\n";
+    out << "c cache clauses:             " << clauses << "\n";
+    out << "c cache load time (s):       " << seconds << "\n";
+    out << "c cache throughput (MB/s):   " << (seconds > 0 ? megabytes / seconds : 0) << "\n";
+}
@@ -0,0 +1,378 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "clause_exchange.h"
+#include "sat_solver.h"
+
+/*
+ * A part of the search space, made of the literals assumed true
+ *
+ * Data members:
+ *   std::vector<int> literals
+ *       The literals, split literals and the literals implied by failed
+ *       lookahead literals
+ */
+
+struct Cube
+{
+    std::vector<int> literals;
+};
+
+/*
+ * Splits the formula into cubes and solves them on several threads
+ *
+ * Every worker reads the original clauses of the formula from a base arena
+ * shared by all of them, and solves the cubes it is given one after the
+ * other under assumptions in a solver of its own, which keeps its learned
+ * clauses from one cube to the next. The search starts from the empty
+ * cube. A cube is searched in rounds of cube_conflicts conflicts, and is
+ * only split in two by a lookahead once a round ends while another worker
+ * has no cube left; until then, the search of the whole cube goes on as it
+ * would without cubes. The child that follows the phase the search would
+ * give the split literal is taken first. Each worker keeps its cubes in a
+ * deque: it takes the deepest one from the back, and an idle worker steals
+ * the shallowest one of another worker from the front. The formula is
+ * unsatisfied once every cube is refuted.
+ *
+ * Eliminated and substituted variables cannot be assumed, so the workers
+ * do not eliminate or substitute variables.
+ *
+ * Member functions:
+ *   bool takeCube(int worker, Cube &cube)
+ *       Takes the next cube of a worker, stealing one if it has none, and
+ *       waits while every cube left is being solved
+ *       @param worker The index of the worker
+ *       @param cube The cube taken
+ *       @return false once the search is over
+ *
+ *   void finishCube(int worker, std::vector<Cube> &children)
+ *       Replaces the cube a worker took by the cubes it was split into
+ *       @param worker The index of the worker
+ *       @param children The new cubes, empty if the cube was refuted
+ *
+ *   void run(int worker)
+ *       Runs a worker, stopping every worker if it throws
+ *       @param worker The index of the worker
+ *
+ *   void conquer(int worker)
+ *       Builds the solver of a worker, then splits and solves cubes until
+ *       the search is over
+ *       @param worker The index of the worker
+ *
+ *   bool solve()
+ *       Starts every worker from the empty cube and waits for all of them
+ *       @return true if the formula is satisfied
+ *               false if the formula is unsatisfied
+ *       @throws The first exception thrown by a worker, such as
+ *               std::length_error for a full clause arena
+ *
+ *   std::vector<std::pair<int, bool>> getAssignment()
+ *       Gets the model found by the worker that satisfied its cube
+ *       @return The value of every variable, sorted by variable
+ *
+ *   void printStatistics(std::ostream &out)
+ *       Prints the cubes handled, the clauses shared by every worker and
+ *       the statistics of the worker that answered (worker 0 if the
+ *       formula is unsatisfied)
+ *       @param out The stream to print to
+ *
+ * Data members:
+ *   SATSolver &formula
+ *       The solver holding the parsed formula, only read
+ *
+ *   SATSolverOptions options
+ *       The configuration of the workers
+ *
+ *   int thread_count
+ *       The number of workers
+ *
+ *   std::vector<std::unique_ptr<SATSolver>> solvers
+ *       The solver of each worker
+ *
+ *   std::vector<std::deque<Cube>> queues
+ *       The cubes of each worker waiting to be split or solved
+ *
+ *   ClauseExchange exchange
+ *       The learned clauses sent from each worker to the others
+ *
+ *   std::atomic<bool> terminate
+ *       Set once a cube is satisfied, which makes the other workers give up
+ *
+ *   std::atomic<int> idle_workers
+ *       The number of workers waiting for a cube, read without the mutex
+ *       by the workers deciding whether to split their cube
+ *
+ *   std::mutex mutex
+ *       Guards the queues and the counters below; cubes take far longer to
+ *       solve than to queue, so every queue shares it
+ *
+ *   std::condition_variable cubes_changed
+ *       Signalled when cubes are queued or the search is over
+ *
+ *   int open_cubes
+ *       The number of cubes queued or being handled
+ *
+ *   int winner
+ *       The worker that satisfied its cube, -1 if there is none
+ *
+ *   long long split_cubes, refuted_cubes, stolen_cubes
+ *       The number of cubes split in two, refuted and stolen
+ *
+ *   std::exception_ptr failure
+ *       The first exception thrown by a worker
+ */
+
+class CubeAndConquer
+{
+private:
+    // Member functions
+    bool takeCube(int, Cube &);
+    void finishCube(int, std::vector<Cube> &);
+    void run(int);
+    void conquer(int);
+
+    // Data members
+    SATSolver &formula;
+    SATSolverOptions options;
+    int thread_count;
+    std::vector<std::unique_ptr<SATSolver>> solvers;
+    std::vector<std::deque<Cube>> queues;
+    ClauseExchange exchange;
+    std::atomic<bool> terminate;
+    std::atomic<int> idle_workers;
+    std::mutex mutex;
+    std::condition_variable cubes_changed;
+    int open_cubes;
+    int winner;
+    long long split_cubes;
+    long long refuted_cubes;
+    long long stolen_cubes;
+    std::exception_ptr failure;
+
+public:
+    // Constructors
+    CubeAndConquer(SATSolver &, SATSolverOptions &, int);
+
+    // Member functions
+    bool solve();
+    std::vector<std::pair<int, bool>> getAssignment();
+    void printStatistics(std::ostream &);
+};
+
+CubeAndConquer::CubeAndConquer(SATSolver &formula, SATSolverOptions &options, int thread_count) : formula(formula), exchange(std::max(1, thread_count), options.share_ring_size), terminate(false), idle_workers(0)
+{
+    this->options = options;
+    this->options.elimination = false;
+    this->options.substitution = false;
+    this->thread_count = std::max(1, thread_count);
+    this->open_cubes = 0;
+    this->winner = -1;
+    this->split_cubes = 0;
+    this->refuted_cubes = 0;
+    this->stolen_cubes = 0;
+}
+
+bool CubeAndConquer::takeCube(int worker, Cube &cube)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        if (terminate.load() || open_cubes == 0)
+        {
+            return false;
+        }
+
+        // The deepest cube of the worker is the one most related to the
+        // clauses it learned last
+        if (!queues[worker].empty())
+        {
+            cube = std::move(queues[worker].back());
+            queues[worker].pop_back();
+            return true;
+        }
+
+        // The shallowest cube of another worker is likely the largest
+        for (int i = 1; i < thread_count; i++)
+        {
+            std::deque<Cube> &queue = queues[(worker + i) % thread_count];
+            if (!queue.empty())
+            {
+                cube = std::move(queue.front());
+                queue.pop_front();
+                stolen_cubes++;
+                return true;
+            }
+        }
+
+        idle_workers++;
+        cubes_changed.wait(lock);
+        idle_workers--;
+    }
+}
+
+void CubeAndConquer::finishCube(int worker, std::vector<Cube> &children)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    for (Cube &child : children)
+    {
+        queues[worker].push_back(std::move(child));
+    }
+    open_cubes += (int)children.size() - 1;
+    if (children.empty())
+    {
+        refuted_cubes++;
+    }
+    else if (children.size() == 2)
+    {
+        split_cubes++;
+    }
+
+    // Wake the idle workers up to steal the new cubes or to stop
+    if (!children.empty() || open_cubes == 0)
+    {
+        cubes_changed.notify_all();
+    }
+}
+
+void CubeAndConquer::run(int worker)
+{
+    try
+    {
+        CubeAndConquer::conquer(worker);
+    }
+    catch (...)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (failure == nullptr)
+        {
+            failure = std::current_exception();
+        }
+        terminate.store(true);
+        cubes_changed.notify_all();
+    }
+}
+
+void CubeAndConquer::conquer(int worker)
+{
+    SATSolverOptions worker_options = options;
+    worker_options.seed = options.seed + worker;
+    solvers[worker].reset(new SATSolver(worker_options));
+    SATSolver &solver = *solvers[worker];
+    solver.shareBaseClauses(formula);
+    solver.setTerminateFlag(&terminate);
+    if (options.sharing && thread_count > 1)
+    {
+        solver.setClauseExchange(&exchange, worker);
+    }
+
+    Cube cube;
+    std::vector<Cube> children;
+    while (CubeAndConquer::takeCube(worker, cube))
+    {
+        // Every cube is searched before it is split, and only split for a
+        // worker left without cubes, so that a formula the search solves
+        // quickly is not cut into cubes that each hold a small part of it
+        SAT answer;
+        do
+        {
+            answer = solver.solveAssuming(cube.literals, options.cube_conflicts);
+        } while (answer == normal && !terminate.load() && idle_workers.load() == 0);
+
+        if (answer == satisfied)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (winner == -1)
+            {
+                winner = worker;
+                terminate.store(true);
+                cubes_changed.notify_all();
+            }
+            break;
+        }
+
+        children.clear();
+        if (answer == normal)
+        {
+            if (terminate.load())
+            {
+                break;
+            }
+
+            // Without a split literal, the cube goes back to be solved
+            // again; otherwise the child that follows the phase of the
+            // split literal is queued last, so that it is taken first
+            int split_literal;
+            if (solver.lookahead(cube.literals, split_literal) == normal)
+            {
+                children.push_back(cube);
+                if (split_literal != 0)
+                {
+                    children.push_back(cube);
+                    children[0].literals.push_back(-split_literal);
+                    children[1].literals.push_back(split_literal);
+                }
+            }
+        }
+        CubeAndConquer::finishCube(worker, children);
+    }
+}
+
+bool CubeAndConquer::solve()
+{
+    solvers.clear();
+    solvers.resize(thread_count);
+    formula.moveClausesToBase();
+    queues.assign(thread_count, std::deque<Cube>());
+    queues[0].push_back({std::vector<int>()});
+    open_cubes = 1;
+    winner = -1;
+    failure = nullptr;
+    terminate.store(false);
+
+    std::vector<std::thread> threads;
+    for (int worker = 0; worker < thread_count; worker++)
+    {
+        threads.emplace_back(&CubeAndConquer::run, this, worker);
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    if (failure != nullptr)
+    {
+        std::rethrow_exception(failure);
+    }
+
+    return winner != -1;
+}
+
+std::vector<std::pair<int, bool>> CubeAndConquer::getAssignment()
+{
+    return solvers[winner]->getAssignment();
+}
+
+void CubeAndConquer::printStatistics(std::ostream &out)
+{
+    out << "c cube threads:              " << thread_count << "\n";
+    out << "c split cubes:               " << split_cubes << "\n";
+    out << "c refuted cubes:             " << refuted_cubes << "\n";
+    out << "c stolen cubes:              " << stolen_cubes << "\n";
+    out << "c answering thread:          " << winner << "\n";
+
+    // Clauses exported, imported and imported then used by each worker
+    for (int worker = 0; worker < thread_count; worker++)
+    {
+        SATSolverStatistics statistics = solvers[worker]->getStatistics();
+        out << "c thread " << worker << " shared clauses:   " << statistics.exported_clauses << " exported, " << statistics.imported_clauses << " imported, " << statistics.imported_clauses_used << " used\n";
+    }
+
+    solvers[std::max(winner, 0)]->printStatistics(out);
+}
@@ -0,0 +1,569 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef HAVE_LZMA
+#include <lzma.h>
+#endif
+#ifdef HAVE_BZIP2
+#include <bzlib.h>
+#endif
+
+/*
+ * The compression formats of an input, detected by their magic bytes
+ *   compression_none: plain text
+ *   compression_gzip: 1f 8b
+ *   compression_xz: fd 37 7a 58 5a 00
+ *   compression_bzip2: "BZh"
+ */
+
+enum CompressionFormat
+{
+    compression_none,
+    compression_gzip,
+    compression_xz,
+    compression_bzip2
+};
+
+// The number of magic bytes needed to tell the formats apart
+const size_t COMPRESSION_MAGIC_SIZE = 6;
+
+/*
+ * Detects the compression format of an input from its first bytes
+ *
+ * @param bytes The first bytes of the input
+ * @param size The number of bytes, at most COMPRESSION_MAGIC_SIZE are read
+ * @return The format, compression_none if no magic bytes match
+ */
+
+CompressionFormat detectCompression(const unsigned char *bytes, size_t size)
+{
+    if (size >= 2 && bytes[0] == 0x1f && bytes[1] == 0x8b)
+    {
+        return compression_gzip;
+    }
+    if (size >= 6 && memcmp(bytes, "\xfd" "7zXZ\0", 6) == 0)
+    {
+        return compression_xz;
+    }
+    if (size >= 3 && memcmp(bytes, "BZh", 3) == 0)
+    {
+        return compression_bzip2;
+    }
+    return compression_none;
+}
+
+// The size of the compressed reads and of the decompressed chunks
+const size_t DECOMPRESSION_CHUNK_SIZE = 1 << 20;
+
+// The number of decompressed chunks the thread may run ahead of the parser
+const size_t DECOMPRESSION_QUEUE_CAPACITY = 4;
+
+/*
+ * A decompressor running on its own thread
+ *
+ * The thread reads the compressed input, inflates it into fixed-size
+ * chunks and hands them over through a bounded queue, so the consumer
+ * parses one chunk while the next one is inflated and the whole text is
+ * never held in memory. Consumed chunks are handed back for reuse.
+ *
+ * Member functions:
+ *   bool next(std::vector<char> &chunk)
+ *       Waits for the next decompressed chunk
+ *       @param chunk Replaced by the next chunk; its previous buffer is
+ *                    recycled
+ *       @return false at the end of the input or after an error
+ *
+ *   bool failed()
+ *       Checks whether decompression stopped on an error
+ *       @return true if there was an error
+ *
+ *   std::string getError()
+ *       Gets the error that stopped decompression
+ *       @return The error message
+ *
+ *   void produce()
+ *       The body of the thread: decompresses the input with the decoder of
+ *       the format and marks the queue finished
+ *
+ *   bool decompressGzip(), decompressXz(), decompressBzip2()
+ *       Decompress the whole input, concatenated streams included
+ *       @return false on an error or if the consumer stopped
+ *
+ *   ssize_t readInput(char *buffer, size_t size)
+ *       Reads compressed bytes, starting with the prefix
+ *       @param buffer The buffer to fill
+ *       @param size The size of the buffer
+ *       @return The number of bytes read, 0 at the end, -1 on an error
+ *
+ *   std::vector<char> takeBuffer()
+ *       Gets a recycled buffer, or a new one, of DECOMPRESSION_CHUNK_SIZE bytes
+ *       @return The buffer
+ *
+ *   bool emit(std::vector<char> &buffer, size_t size)
+ *       Queues the first bytes of the buffer, waiting while the queue is full
+ *       @param buffer The buffer, moved into the queue
+ *       @param size The number of decompressed bytes in it
+ *       @return false if the consumer stopped
+ *
+ *   bool fail(const std::string &message)
+ *       Records an error
+ *       @param message The error
+ *       @return false
+ *
+ * Data members:
+ *   int fd
+ *       The compressed input
+ *
+ *   CompressionFormat format
+ *       The format of the input
+ *
+ *   std::string prefix
+ *       The bytes already read from the input to detect its format
+ *
+ *   size_t prefix_position
+ *       The number of prefix bytes handed to the decoder
+ *
+ *   std::mutex mutex
+ *       Guards the queue, the free buffers and the flags below
+ *
+ *   std::condition_variable changed
+ *       Signalled whenever the queue or a flag changes
+ *
+ *   std::deque<std::vector<char>> queue
+ *       The decompressed chunks not consumed yet
+ *
+ *   std::vector<std::vector<char>> free_buffers
+ *       Buffers handed back by the consumer
+ *
+ *   bool finished, cancelled
+ *       Whether the thread is done, and whether the consumer stopped
+ *
+ *   std::string error
+ *       The error that stopped decompression, empty if none
+ *
+ *   std::thread worker
+ *       The decompression thread
+ */
+
+class Decompressor
+{
+private:
+    // Member functions
+    void produce();
+    bool decompressGzip();
+    bool decompressXz();
+    bool decompressBzip2();
+    ssize_t readInput(char *, size_t);
+    std::vector<char> takeBuffer();
+    bool emit(std::vector<char> &, size_t);
+    bool fail(const std::string &);
+
+    // Data members
+    int fd;
+    CompressionFormat format;
+    std::string prefix;
+    size_t prefix_position;
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::deque<std::vector<char>> queue;
+    std::vector<std::vector<char>> free_buffers;
+    bool finished;
+    bool cancelled;
+    std::string error;
+    std::thread worker;
+
+public:
+    // Constructors
+    Decompressor(int, CompressionFormat, const char *, size_t);
+    ~Decompressor();
+
+    // Member functions
+    bool next(std::vector<char> &);
+    bool failed();
+    std::string getError();
+};
+
+Decompressor::Decompressor(int fd, CompressionFormat format, const char *prefix, size_t prefix_size) : prefix(prefix, prefix_size)
+{
+    this->fd = fd;
+    this->format = format;
+    this->prefix_position = 0;
+    this->finished = false;
+    this->cancelled = false;
+
+    // Start inflating right away, before the first chunk is asked for
+    worker = std::thread(&Decompressor::produce, this);
+}
+
+Decompressor::~Decompressor()
+{
+    // Stop the thread if the consumer gave up before the end
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        cancelled = true;
+    }
+    changed.notify_all();
+    worker.join();
+}
+
+bool Decompressor::next(std::vector<char> &chunk)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    if (chunk.capacity() > 0)
+    {
+        free_buffers.push_back(std::move(chunk));
+        changed.notify_all();
+    }
+
+    changed.wait(lock, [this]
+                 { return !queue.empty() || finished; });
+
+    // Stop at an error even if chunks are left, they may be cut mid-line
+    if (queue.empty() || !error.empty())
+    {
+        return false;
+    }
+
+    chunk = std::move(queue.front());
+    queue.pop_front();
+    changed.notify_all();
+    return true;
+}
+
+bool Decompressor::failed()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return !error.empty();
+}
+
+std::string Decompressor::getError()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return error;
+}
+
+void Decompressor::produce()
+{
+    if (format == compression_gzip)
+    {
+        Decompressor::decompressGzip();
+    }
+    else if (format == compression_xz)
+    {
+        Decompressor::decompressXz();
+    }
+    else if (format == compression_bzip2)
+    {
+        Decompressor::decompressBzip2();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    finished = true;
+    changed.notify_all();
+}
+
+ssize_t Decompressor::readInput(char *buffer, size_t size)
+{
+    // The magic bytes come first, they were read before the thread started
+    if (prefix_position < prefix.size())
+    {
+        size_t count = std::min(size, prefix.size() - prefix_position);
+        memcpy(buffer, prefix.data() + prefix_position, count);
+        prefix_position += count;
+        return count;
+    }
+
+    ssize_t bytes_read;
+    do
+    {
+        bytes_read = read(fd, buffer, size);
+    } while (bytes_read < 0 && errno == EINTR);
+    return bytes_read;
+}
+
+std::vector<char> Decompressor::takeBuffer()
+{
+    std::vector<char> buffer;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!free_buffers.empty())
+        {
+            buffer = std::move(free_buffers.back());
+            free_buffers.pop_back();
+        }
+    }
+    buffer.resize(DECOMPRESSION_CHUNK_SIZE);
+    return buffer;
+}
+
+bool Decompressor::emit(std::vector<char> &buffer, size_t size)
+{
+    if (size == 0)
+    {
+        return true;
+    }
+
+    buffer.resize(size);
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [this]
+                 { return queue.size() < DECOMPRESSION_QUEUE_CAPACITY || cancelled; });
+    if (cancelled)
+    {
+        return false;
+    }
+
+    queue.push_back(std::move(buffer));
+    changed.notify_all();
+    return true;
+}
+
+bool Decompressor::fail(const std::string &message)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    error = message;
+    return false;
+}
+
+bool Decompressor::decompressGzip()
+{
+#ifdef HAVE_ZLIB
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+
+    // 15 + 32: the largest window, with gzip and zlib headers detected
+    if (inflateInit2(&stream, 15 + 32) != Z_OK)
+    {
+        return Decompressor::fail("cannot initialize gzip decompression");
+    }
+
+    std::vector<char> input(DECOMPRESSION_CHUNK_SIZE);
+    std::vector<char> output = Decompressor::takeBuffer();
+    stream.next_out = reinterpret_cast<Bytef *>(output.data());
+    stream.avail_out = output.size();
+    bool stream_ended = false;
+    bool valid = true;
+
+    while (valid)
+    {
+        if (stream.avail_in == 0)
+        {
+            ssize_t bytes_read = Decompressor::readInput(input.data(), input.size());
+            if (bytes_read < 0)
+            {
+                valid = Decompressor::fail("cannot read the gzip input");
+                break;
+            }
+            if (bytes_read == 0)
+            {
+                break;
+            }
+            stream.next_in = reinterpret_cast<Bytef *>(input.data());
+            stream.avail_in = bytes_read;
+        }
+
+        int status = inflate(&stream, Z_NO_FLUSH);
+        stream_ended = status == Z_STREAM_END;
+        if (stream_ended)
+        {
+            // Concatenated gzip members decompress to the concatenated texts
+            inflateReset(&stream);
+        }
+        else if (status != Z_OK && status != Z_BUF_ERROR)
+        {
+            valid = Decompressor::fail(std::string("corrupted gzip input: ") + (stream.msg ? stream.msg : "unknown error"));
+            break;
+        }
+
+        if (stream.avail_out == 0)
+        {
+            valid = Decompressor::emit(output, output.size());
+            output = Decompressor::takeBuffer();
+            stream.next_out = reinterpret_cast<Bytef *>(output.data());
+            stream.avail_out = output.size();
+        }
+    }
+
+    if (valid)
+    {
+        valid = Decompressor::emit(output, output.size() - stream.avail_out);
+    }
+    if (valid && !stream_ended)
+    {
+        valid = Decompressor::fail("truncated gzip input");
+    }
+
+    inflateEnd(&stream);
+    return valid;
+#else
+    return Decompressor::fail("gzip input, but compiled without zlib");
+#endif
+}
+
+bool Decompressor::decompressXz()
+{
+#ifdef HAVE_LZMA
+    lzma_stream stream = LZMA_STREAM_INIT;
+    if (lzma_stream_decoder(&stream, UINT64_MAX, LZMA_CONCATENATED) != LZMA_OK)
+    {
+        return Decompressor::fail("cannot initialize xz decompression");
+    }
+
+    std::vector<char> input(DECOMPRESSION_CHUNK_SIZE);
+    std::vector<char> output = Decompressor::takeBuffer();
+    stream.next_out = reinterpret_cast<uint8_t *>(output.data());
+    stream.avail_out = output.size();
+    lzma_action action = LZMA_RUN;
+    bool valid = true;
+
+    while (valid)
+    {
+        if (stream.avail_in == 0 && action == LZMA_RUN)
+        {
+            ssize_t bytes_read = Decompressor::readInput(input.data(), input.size());
+            if (bytes_read < 0)
+            {
+                valid = Decompressor::fail("cannot read the xz input");
+                break;
+            }
+
+            // With concatenated streams, the end is only known once told
+            if (bytes_read == 0)
+            {
+                action = LZMA_FINISH;
+            }
+            stream.next_in = reinterpret_cast<uint8_t *>(input.data());
+            stream.avail_in = bytes_read;
+        }
+
+        lzma_ret status = lzma_code(&stream, action);
+        if (status == LZMA_STREAM_END)
+        {
+            break;
+        }
+        else if (status != LZMA_OK)
+        {
+            valid = Decompressor::fail(status == LZMA_BUF_ERROR ? "truncated xz input" : "corrupted xz input");
+            break;
+        }
+
+        if (stream.avail_out == 0)
+        {
+            valid = Decompressor::emit(output, output.size());
+            output = Decompressor::takeBuffer();
+            stream.next_out = reinterpret_cast<uint8_t *>(output.data());
+            stream.avail_out = output.size();
+        }
+    }
+
+    if (valid)
+    {
+        valid = Decompressor::emit(output, output.size() - stream.avail_out);
+    }
+
+    lzma_end(&stream);
+    return valid;
+#else
+    return Decompressor::fail("xz input, but compiled without liblzma");
+#endif
+}
+
+bool Decompressor::decompressBzip2()
+{
+#ifdef HAVE_BZIP2
+    bz_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    if (BZ2_bzDecompressInit(&stream, 0, 0) != BZ_OK)
+    {
+        return Decompressor::fail("cannot initialize bzip2 decompression");
+    }
+
+    std::vector<char> input(DECOMPRESSION_CHUNK_SIZE);
+    std::vector<char> output = Decompressor::takeBuffer();
+    stream.next_out = output.data();
+    stream.avail_out = output.size();
+    bool stream_ended = false;
+    bool valid = true;
+
+    while (valid)
+    {
+        if (stream.avail_in == 0)
+        {
+            ssize_t bytes_read = Decompressor::readInput(input.data(), input.size());
+            if (bytes_read < 0)
+            {
+                valid = Decompressor::fail("cannot read the bzip2 input");
+                break;
+            }
+            if (bytes_read == 0)
+            {
+                break;
+            }
+            stream.next_in = input.data();
+            stream.avail_in = bytes_read;
+        }
+
+        int status = BZ2_bzDecompress(&stream);
+        stream_ended = status == BZ_STREAM_END;
+        if (stream_ended)
+        {
+            // Concatenated bzip2 streams need a fresh decoder each, which
+            // keeps the unread input and the output position
+            char *next_in = stream.next_in;
+            unsigned int avail_in = stream.avail_in;
+            char *next_out = stream.next_out;
+            unsigned int avail_out = stream.avail_out;
+            BZ2_bzDecompressEnd(&stream);
+            memset(&stream, 0, sizeof(stream));
+            if (BZ2_bzDecompressInit(&stream, 0, 0) != BZ_OK)
+            {
+                valid = Decompressor::fail("cannot initialize bzip2 decompression");
+                break;
+            }
+            stream.next_in = next_in;
+            stream.avail_in = avail_in;
+            stream.next_out = next_out;
+            stream.avail_out = avail_out;
+        }
+        else if (status != BZ_OK)
+        {
+            valid = Decompressor::fail("corrupted bzip2 input");
+            break;
+        }
+
+        if (stream.avail_out == 0)
+        {
+            valid = Decompressor::emit(output, output.size());
+            output = Decompressor::takeBuffer();
+            stream.next_out = output.data();
+            stream.avail_out = output.size();
+        }
+    }
+
+    if (valid)
+    {
+        valid = Decompressor::emit(output, output.size() - stream.avail_out);
+    }
+    if (valid && !stream_ended)
+    {
+        valid = Decompressor::fail("truncated bzip2 input");
+    }
+
+    BZ2_bzDecompressEnd(&stream);
+    return valid;
+#else
+    return Decompressor::fail("bzip2 input, but compiled without libbz2");
+#endif
+}
@@ -0,0 +1,981 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "cnf_cache.h"
+#include "decompressor.h"
+#include "sat_solver.h"
+
+/*
+ * Counters collected while parsing a DIMACS input
+ *
+ * Data members:
+ *   long long bytes
+ *       The number of bytes read
+ *
+ *   long long clauses
+ *       The number of clauses read
+ *
+ *   long long literals
+ *       The number of literals read
+ *
+ *   int max_variable
+ *       The largest variable read
+ *
+ *   int variables
+ *       The number of variables of the problem line, or the largest
+ *       variable read if there is none
+ *
+ *   double seconds
+ *       The time spent parsing
+ *
+ *   int threads
+ *       The number of threads that scanned the input
+ *
+ *   double split_seconds, scan_seconds, merge_seconds, wait_seconds
+ *       For a parallel parse, the time spent cutting the input into chunks,
+ *       the time all threads spent scanning chunks, the time spent adding
+ *       the scanned clauses to the solver, and the time spent waiting for
+ *       the next chunk
+ */
+
+struct DIMACSStatistics
+{
+    long long bytes = 0;
+    long long clauses = 0;
+    long long literals = 0;
+    int max_variable = 0;
+    int variables = 0;
+    double seconds = 0;
+    int threads = 1;
+    double split_seconds = 0;
+    double scan_seconds = 0;
+    double merge_seconds = 0;
+    double wait_seconds = 0;
+};
+
+/*
+ * A piece of a mapped DIMACS input scanned by a worker thread
+ *
+ * Data members:
+ *   const char *begin, *end
+ *       The bytes of the chunk, which ends just after a newline unless it
+ *       is the last one
+ *
+ *   std::vector<int> literals
+ *       The clauses read, each one followed by a 0
+ *
+ *   int max_variable
+ *       The largest variable read
+ *
+ *   long long lines
+ *       The number of newlines in the chunk
+ *
+ *   bool scanned, valid, ended
+ *       Whether the chunk has been scanned, whether it is valid, and
+ *       whether it has the '%' line that ends the input
+ *
+ *   bool problem_line
+ *       Whether the chunk has a problem line, which is left to the parser
+ *       of the input
+ *
+ *   std::string error
+ *       The error found, if any
+ *
+ *   long long error_line
+ *       The line of the error, counted from the start of the chunk
+ *
+ *   double seconds
+ *       The time spent scanning the chunk
+ */
+
+struct DIMACSChunk
+{
+    const char *begin = nullptr;
+    const char *end = nullptr;
+    std::vector<int> literals;
+    int max_variable = 0;
+    long long lines = 0;
+    bool scanned = false;
+    bool valid = true;
+    bool ended = false;
+    bool problem_line = false;
+    std::string error;
+    long long error_line = 0;
+    double seconds = 0;
+};
+
+/*
+ * A DIMACS CNF parser that adds every clause straight to a SATSolver
+ *
+ * The input is pushed in chunks of any size, so a number or a line may be
+ * split between two chunks. Comment lines start with 'c', the problem line
+ * "p cnf <variables> <clauses>" is optional, and a line starting with '%'
+ * ends the input. A clause ends with 0 or, if the 0 is missing, with the
+ * end of its line. Errors are printed to std::cerr with their line number.
+ *
+ * Since clauses never span lines, a large mapped input can be cut into
+ * chunks at newlines and scanned by several threads; the scanned clauses
+ * are then added to the solver chunk by chunk in the order of the input,
+ * so the solver sees exactly the same formula as with a single thread.
+ *
+ * Member functions:
+ *   bool parseFile(const std::string &path)
+ *       Parses a whole file, mapping it into memory when possible and
+ *       reading it in chunks otherwise; gzip, xz and bzip2 files are
+ *       detected by their magic bytes and decompressed on another thread
+ *       @param path The path of the file
+ *       @return true if the file is valid DIMACS
+ *
+ *   bool parseDescriptor(int fd, const std::string &name)
+ *       Parses everything readable from an open file descriptor, such as
+ *       stdin or a pipe, clause by clause as the bytes arrive
+ *       @param fd The file descriptor, which stays open
+ *       @param name The name of the input in error messages
+ *       @return true if the input is valid DIMACS
+ *
+ *   bool parse(const char *data, size_t size)
+ *       Parses the next chunk of the input
+ *       @param data The chunk
+ *       @param size The number of bytes in the chunk
+ *       @return false if the chunk has an error
+ *
+ *   bool finish()
+ *       Ends the input: adds a last clause missing its 0 and checks the
+ *       counts of the problem line
+ *       @return false if the input has an error
+ *
+ *   void setThreads(int threads)
+ *       Sets the number of threads scanning mapped inputs
+ *       @param threads The number of threads, 1 to scan on the calling thread
+ *
+ *   void setCacheWriter(CNFCacheWriter *cache_writer)
+ *       Also writes every clause read to a CNF cache
+ *       @param cache_writer The open cache writer
+ *
+ *   DIMACSStatistics getStatistics()
+ *       Gets the counters collected while parsing
+ *       @return The statistics
+ *
+ *   void printStatistics(std::ostream &out)
+ *       Prints the counters and the parse throughput as DIMACS comments
+ *       @param out The stream to print to
+ *
+ *   bool parseCompressed(int fd, CompressionFormat format, const char *prefix, size_t prefix_size)
+ *       Parses the chunks of a Decompressor as they are inflated
+ *       @param fd The compressed input
+ *       @param format The compression format
+ *       @param prefix, prefix_size The bytes already read from the input
+ *       @return false if the input has an error
+ *
+ *   bool parseParallel(const char *data, size_t size)
+ *       Parses the header lines, then scans chunks of the rest on worker
+ *       threads while adding the clauses of the scanned chunks in order
+ *       @param data The mapped input
+ *       @param size The size of the input
+ *       @return false if the input has an error
+ *
+ *   static void scanChunk(DIMACSChunk &chunk, bool problem_line_found, int declared_variables)
+ *       Scans a chunk into its literal buffer with a parser of its own
+ *       @param chunk The chunk
+ *       @param problem_line_found, declared_variables The problem line of
+ *                                                     the input
+ *
+ *   bool mergeChunk(DIMACSChunk &chunk)
+ *       Adds the clauses of a scanned chunk to the solver
+ *       @param chunk The chunk
+ *       @return false if the chunk has an error
+ *
+ *   bool endInput()
+ *       Adds a last literal or clause cut by the end of the input
+ *       @return false if it has an error
+ *
+ *   void addClause(const int *literals, int size)
+ *       Adds a clause to the solver and the cache, and counts it
+ *       @param literals The literals of the clause
+ *       @param size The number of literals
+ *
+ *   bool addLiteral(long long value)
+ *       Adds a literal to the current clause, or ends it if the value is 0
+ *       @param value The literal read
+ *       @return false if the literal is out of range
+ *
+ *   void endClause()
+ *       Adds the current clause to the solver, or to chunk_literals for
+ *       the parser of a chunk
+ *
+ *   bool parseProblemLine()
+ *       Reads the variable and clause counts from the problem line and
+ *       creates the declared variables
+ *       @return false if the problem line is malformed or repeated
+ *
+ *   bool error(const std::string &message)
+ *       Prints an error with the current line number, or records it for
+ *       the parser of a chunk
+ *       @param message The error
+ *       @return false
+ *
+ * Data members:
+ *   SATSolver *solver
+ *       The solver receiving the clauses, nullptr for the parser of a chunk
+ *
+ *   std::vector<int> chunk_literals
+ *       The clauses read by the parser of a chunk, each followed by a 0
+ *
+ *   std::string error_message
+ *       The error found by the parser of a chunk
+ *
+ *   LineState state
+ *       What the rest of the current line is
+ *
+ *   std::string problem_line
+ *       The part of the problem line read so far
+ *
+ *   std::vector<int> clause
+ *       The literals of the current clause
+ *
+ *   bool in_number, negative
+ *       Whether a number is split between two chunks, and its sign
+ *
+ *   long long number
+ *       The digits of that number read so far
+ *
+ *   bool problem_line_found
+ *       Whether the problem line has been read
+ *
+ *   int declared_variables, declared_clauses
+ *       The counts of the problem line
+ *
+ *   long long line_number
+ *       The line being parsed, starting from 1
+ *
+ *   CNFCacheWriter *cache_writer
+ *       The cache receiving a copy of the clauses, nullptr if none
+ *
+ *   int threads
+ *       The number of threads scanning mapped inputs
+ *
+ *   std::chrono::steady_clock::time_point start_time
+ *       When the first chunk arrived
+ *
+ *   DIMACSStatistics statistics
+ *       The counters collected while parsing
+ */
+
+class DIMACSParser
+{
+private:
+    // The part of a line the parser is in
+    enum LineState
+    {
+        line_start,
+        clause_line,
+        comment_line,
+        problem,
+        end_of_input
+    };
+
+    // Constructors
+    DIMACSParser();
+
+    // Member functions
+    bool parseCompressed(int, CompressionFormat, const char *, size_t);
+    bool parseParallel(const char *, size_t);
+    static void scanChunk(DIMACSChunk &, bool, int);
+    bool mergeChunk(DIMACSChunk &);
+    bool endInput();
+    void addClause(const int *, int);
+    bool addLiteral(long long);
+    void endClause();
+    bool parseProblemLine();
+    bool error(const std::string &);
+
+    // Data members
+    SATSolver *solver;
+    std::vector<int> chunk_literals;
+    std::string error_message;
+    LineState state;
+    std::string problem_line;
+    std::vector<int> clause;
+    bool in_number;
+    bool negative;
+    long long number;
+    bool problem_line_found;
+    int declared_variables;
+    int declared_clauses;
+    long long line_number;
+    CNFCacheWriter *cache_writer;
+    int threads;
+    std::chrono::steady_clock::time_point start_time;
+    DIMACSStatistics statistics;
+
+public:
+    // Constructors
+    DIMACSParser(SATSolver &);
+
+    // Member functions
+    bool parseFile(const std::string &);
+    bool parseDescriptor(int, const std::string &);
+    bool parse(const char *, size_t);
+    bool finish();
+    void setThreads(int);
+    void setCacheWriter(CNFCacheWriter *);
+    DIMACSStatistics getStatistics();
+    void printStatistics(std::ostream &);
+};
+
+// The size of the chunks read from inputs that cannot be mapped
+const size_t DIMACS_CHUNK_SIZE = 1 << 20;
+
+// The size of the chunks scanned by the threads of a parallel parse
+const size_t DIMACS_PARALLEL_CHUNK_SIZE = 8 << 20;
+
+DIMACSParser::DIMACSParser(SATSolver &solver) : DIMACSParser()
+{
+    this->solver = &solver;
+}
+
+DIMACSParser::DIMACSParser()
+{
+    this->solver = nullptr;
+    this->state = line_start;
+    this->in_number = false;
+    this->negative = false;
+    this->number = 0;
+    this->problem_line_found = false;
+    this->declared_variables = 0;
+    this->declared_clauses = 0;
+    this->line_number = 1;
+    this->cache_writer = nullptr;
+    this->threads = 1;
+}
+
+bool DIMACSParser::parseFile(const std::string &path)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return DIMACSParser::error("cannot open " + path);
+    }
+
+    bool valid = DIMACSParser::parseDescriptor(fd, path);
+    close(fd);
+    return valid;
+}
+
+bool DIMACSParser::parseDescriptor(int fd, const std::string &name)
+{
+    // Read the magic bytes, which may take several reads from a pipe
+    char magic[COMPRESSION_MAGIC_SIZE];
+    size_t magic_size = 0;
+    ssize_t bytes_read = 1;
+    while (magic_size < COMPRESSION_MAGIC_SIZE && (bytes_read = read(fd, magic + magic_size, COMPRESSION_MAGIC_SIZE - magic_size)) > 0)
+    {
+        magic_size += bytes_read;
+    }
+
+    struct stat file_stat;
+    bool valid = true;
+    void *mapped = MAP_FAILED;
+    CompressionFormat format = detectCompression(reinterpret_cast<unsigned char *>(magic), magic_size);
+    if (bytes_read < 0)
+    {
+        valid = DIMACSParser::error("cannot read " + name);
+    }
+    else if (format != compression_none)
+    {
+        valid = DIMACSParser::parseCompressed(fd, format, magic, magic_size);
+    }
+    else if (fstat(fd, &file_stat) == 0 && S_ISREG(file_stat.st_mode) && file_stat.st_size > 0 &&
+             (mapped = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0)) != MAP_FAILED)
+    {
+        // The file is read straight from the page cache, as a single chunk
+        // or as many chunks scanned in parallel
+        madvise(mapped, file_stat.st_size, MADV_SEQUENTIAL);
+        if (threads > 1 && file_stat.st_size >= 2 * DIMACS_PARALLEL_CHUNK_SIZE)
+        {
+            valid = DIMACSParser::parseParallel(static_cast<const char *>(mapped), file_stat.st_size);
+        }
+        else
+        {
+            valid = DIMACSParser::parse(static_cast<const char *>(mapped), file_stat.st_size);
+        }
+        munmap(mapped, file_stat.st_size);
+    }
+    else
+    {
+        // Pipes and empty files cannot be mapped, so read them in chunks,
+        // parsing whatever each read returns without waiting for more
+        std::vector<char> buffer(DIMACS_CHUNK_SIZE);
+        valid = DIMACSParser::parse(magic, magic_size);
+        while (valid && (bytes_read = read(fd, buffer.data(), buffer.size())) > 0)
+        {
+            valid = DIMACSParser::parse(buffer.data(), bytes_read);
+        }
+
+        if (bytes_read < 0)
+        {
+            valid = DIMACSParser::error("cannot read " + name);
+        }
+    }
+
+    return valid && DIMACSParser::finish();
+}
+
+bool DIMACSParser::parseCompressed(int fd, CompressionFormat format, const char *prefix, size_t prefix_size)
+{
+    // Parse each chunk while the decompressor inflates the next ones
+    Decompressor decompressor(fd, format, prefix, prefix_size);
+    std::vector<char> chunk;
+    bool valid = true;
+    while (valid && decompressor.next(chunk))
+    {
+        valid = DIMACSParser::parse(chunk.data(), chunk.size());
+    }
+
+    if (valid && decompressor.failed())
+    {
+        valid = DIMACSParser::error(decompressor.getError());
+    }
+
+    return valid;
+}
+
+bool DIMACSParser::parseParallel(const char *data, size_t size)
+{
+    std::chrono::steady_clock::time_point split_start = std::chrono::steady_clock::now();
+
+    // The comment and problem lines at the top are parsed first, so that
+    // every chunk knows the declared number of variables
+    size_t header_size = 0;
+    while (header_size < size && (data[header_size] == 'c' || data[header_size] == 'p' || data[header_size] == '\n'))
+    {
+        const char *newline = static_cast<const char *>(memchr(data + header_size, '\n', size - header_size));
+        header_size = newline == nullptr ? size : newline - data + 1;
+    }
+
+    if (!DIMACSParser::parse(data, header_size))
+    {
+        return false;
+    }
+
+    if (state == end_of_input)
+    {
+        return true;
+    }
+
+    // Cut the rest of the input just after the first newline past each
+    // multiple of the chunk size
+    std::vector<DIMACSChunk> chunks;
+    const char *end = data + size;
+    const char *position = data + header_size;
+    while (position < end)
+    {
+        const char *chunk_end = end;
+        if (end - position > DIMACS_PARALLEL_CHUNK_SIZE)
+        {
+            const char *newline = static_cast<const char *>(memchr(position + DIMACS_PARALLEL_CHUNK_SIZE, '\n', end - position - DIMACS_PARALLEL_CHUNK_SIZE));
+            chunk_end = newline == nullptr ? end : newline + 1;
+        }
+        chunks.emplace_back();
+        chunks.back().begin = position;
+        chunks.back().end = chunk_end;
+        position = chunk_end;
+    }
+    statistics.bytes += size - header_size;
+    statistics.threads = threads;
+    std::chrono::duration<double> split_elapsed = std::chrono::steady_clock::now() - split_start;
+    statistics.split_seconds = split_elapsed.count();
+
+    // Workers take the chunks in order, but stay within a window of the
+    // chunks being merged so that scanned clauses do not pile up
+    std::mutex mutex;
+    std::condition_variable changed;
+    size_t next_chunk = 0;
+    size_t merged_chunks = 0;
+    size_t window = 2 * threads;
+    bool stopping = false;
+    bool problem_line_found = this->problem_line_found;
+    int declared_variables = this->declared_variables;
+
+    auto work = [&]()
+    {
+        while (true)
+        {
+            size_t index;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [&]
+                             { return stopping || next_chunk >= chunks.size() || next_chunk < merged_chunks + window; });
+                if (stopping || next_chunk >= chunks.size())
+                {
+                    return;
+                }
+                index = next_chunk++;
+            }
+
+            DIMACSParser::scanChunk(chunks[index], problem_line_found, declared_variables);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                chunks[index].scanned = true;
+            }
+            changed.notify_all();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threads; i++)
+    {
+        workers.emplace_back(work);
+    }
+
+    // Merge the chunks in the order of the input as soon as they are scanned
+    bool valid = true;
+    for (size_t i = 0; i < chunks.size() && valid; i++)
+    {
+        std::chrono::steady_clock::time_point wait_start = std::chrono::steady_clock::now();
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [&]
+                         { return chunks[i].scanned; });
+        }
+        std::chrono::steady_clock::time_point merge_start = std::chrono::steady_clock::now();
+        std::chrono::duration<double> wait_elapsed = merge_start - wait_start;
+        statistics.wait_seconds += wait_elapsed.count();
+
+        valid = DIMACSParser::mergeChunk(chunks[i]);
+        bool ended = state == end_of_input;
+        std::vector<int>().swap(chunks[i].literals);
+
+        std::chrono::duration<double> merge_elapsed = std::chrono::steady_clock::now() - merge_start;
+        statistics.merge_seconds += merge_elapsed.count();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            merged_chunks = i + 1;
+            stopping = ended;
+        }
+        changed.notify_all();
+
+        if (ended)
+        {
+            break;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    changed.notify_all();
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+
+    return valid;
+}
+
+void DIMACSParser::scanChunk(DIMACSChunk &chunk, bool problem_line_found, int declared_variables)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    // A parser without a solver collects the clauses of the chunk
+    DIMACSParser parser;
+    parser.problem_line_found = problem_line_found;
+    parser.declared_variables = declared_variables;
+    chunk.valid = parser.parse(chunk.begin, chunk.end - chunk.begin) && parser.endInput();
+    chunk.literals.swap(parser.chunk_literals);
+    chunk.max_variable = parser.statistics.max_variable;
+    chunk.lines = parser.line_number - 1;
+    chunk.ended = parser.state == end_of_input;
+    chunk.problem_line = parser.problem_line_found && !problem_line_found;
+    chunk.error = parser.error_message;
+    chunk.error_line = parser.line_number;
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    chunk.seconds = elapsed.count();
+}
+
+bool DIMACSParser::mergeChunk(DIMACSChunk &chunk)
+{
+    statistics.scan_seconds += chunk.seconds;
+
+    // A chunk with a late problem line, or with variables beyond it, was
+    // scanned without knowing it, so it is parsed again here
+    if (chunk.problem_line || (problem_line_found && chunk.max_variable > declared_variables))
+    {
+        statistics.bytes -= chunk.end - chunk.begin;
+        return DIMACSParser::parse(chunk.begin, chunk.end - chunk.begin);
+    }
+
+    if (!chunk.valid)
+    {
+        line_number += chunk.error_line - 1;
+        return DIMACSParser::error(chunk.error);
+    }
+
+    int start = 0;
+    for (int i = 0; i < chunk.literals.size(); i++)
+    {
+        if (chunk.literals[i] == 0)
+        {
+            DIMACSParser::addClause(chunk.literals.data() + start, i - start);
+            start = i + 1;
+        }
+    }
+
+    statistics.max_variable = std::max(statistics.max_variable, chunk.max_variable);
+    line_number += chunk.lines;
+    if (chunk.ended)
+    {
+        state = end_of_input;
+    }
+    return true;
+}
+
+bool DIMACSParser::parse(const char *data, size_t size)
+{
+    if (statistics.bytes == 0)
+    {
+        start_time = std::chrono::steady_clock::now();
+    }
+    statistics.bytes += size;
+
+    const char *end = data + size;
+    const char *p = data;
+    while (p < end)
+    {
+        // Finish a number split by the previous chunk before anything else
+        if (in_number)
+        {
+            if (negative && number == 0 && (*p < '0' || *p > '9'))
+            {
+                return DIMACSParser::error("expected a digit after '-'");
+            }
+
+            while (p < end && *p >= '0' && *p <= '9')
+            {
+                number = number * 10 + (*p++ - '0');
+                if (number > INT_MAX)
+                {
+                    return DIMACSParser::error("literal out of range");
+                }
+            }
+
+            if (p == end)
+            {
+                break;
+            }
+
+            in_number = false;
+            if (!DIMACSParser::addLiteral(negative ? -number : number))
+            {
+                return false;
+            }
+        }
+
+        char c = *p;
+
+        if (state == end_of_input)
+        {
+            break;
+        }
+        else if (state == comment_line)
+        {
+            // Skip to the end of the line without looking at every character
+            const char *newline = static_cast<const char *>(memchr(p, '\n', end - p));
+            if (newline == nullptr)
+            {
+                break;
+            }
+            p = newline;
+            state = line_start;
+            line_number++;
+            p++;
+            continue;
+        }
+        else if (state == problem)
+        {
+            if (c == '\n')
+            {
+                if (!DIMACSParser::parseProblemLine())
+                {
+                    return false;
+                }
+                state = line_start;
+                line_number++;
+            }
+            else
+            {
+                problem_line += c;
+            }
+            p++;
+            continue;
+        }
+
+        if (state == line_start)
+        {
+            if (c == 'c')
+            {
+                state = comment_line;
+                p++;
+                continue;
+            }
+            else if (c == 'p')
+            {
+                state = problem;
+                problem_line.clear();
+                p++;
+                continue;
+            }
+            else if (c == '%')
+            {
+                state = end_of_input;
+                break;
+            }
+            state = clause_line;
+        }
+
+        if (c == '\n')
+        {
+            // A line of literals without a 0 still makes a clause
+            if (!clause.empty())
+            {
+                DIMACSParser::endClause();
+            }
+            state = line_start;
+            line_number++;
+            p++;
+        }
+        else if (c == ' ' || c == '\t' || c == '\r')
+        {
+            p++;
+        }
+        else if (c == '-' || (c >= '0' && c <= '9'))
+        {
+            negative = c == '-';
+            if (negative)
+            {
+                p++;
+                if (p < end && (*p < '0' || *p > '9'))
+                {
+                    return DIMACSParser::error("expected a digit after '-'");
+                }
+            }
+
+            // Scan the digits in place; a number cut by the end of the chunk
+            // is finished by the next call
+            number = 0;
+            while (p < end && *p >= '0' && *p <= '9')
+            {
+                number = number * 10 + (*p++ - '0');
+                if (number > INT_MAX)
+                {
+                    return DIMACSParser::error("literal out of range");
+                }
+            }
+
+            if (p == end)
+            {
+                in_number = true;
+                break;
+            }
+
+            if (!DIMACSParser::addLiteral(negative ? -number : number))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            return DIMACSParser::error(std::string("unexpected character '") + c + "'");
+        }
+    }
+
+    return true;
+}
+
+bool DIMACSParser::addLiteral(long long value)
+{
+    if (value == 0)
+    {
+        DIMACSParser::endClause();
+        return true;
+    }
+
+    int variable = value > 0 ? value : -value;
+    if (problem_line_found && variable > declared_variables)
+    {
+        return DIMACSParser::error("variable " + std::to_string(variable) + " exceeds the " + std::to_string(declared_variables) + " variables of the problem line");
+    }
+
+    statistics.max_variable = std::max(statistics.max_variable, variable);
+    clause.push_back(value);
+    return true;
+}
+
+void DIMACSParser::endClause()
+{
+    if (solver == nullptr)
+    {
+        chunk_literals.insert(chunk_literals.end(), clause.begin(), clause.end());
+        chunk_literals.push_back(0);
+    }
+    else
+    {
+        DIMACSParser::addClause(clause.data(), clause.size());
+    }
+    clause.clear();
+}
+
+void DIMACSParser::addClause(const int *literals, int size)
+{
+    solver->addClause(literals, size);
+    if (cache_writer != nullptr)
+    {
+        cache_writer->addClause(literals, size);
+    }
+    statistics.clauses++;
+    statistics.literals += size;
+}
+
+bool DIMACSParser::parseProblemLine()
+{
+    if (problem_line_found)
+    {
+        return DIMACSParser::error("second problem line");
+    }
+
+    // A problem line after the first clauses stops the parser of a chunk,
+    // and the chunk is parsed again in order
+    if (solver == nullptr)
+    {
+        problem_line_found = true;
+        return DIMACSParser::error("problem line");
+    }
+
+    // The leading 'p' has already been consumed
+    char format[8];
+    int variables, clauses;
+    char extra;
+    if (sscanf(problem_line.c_str(), " %7s %d %d %c", format, &variables, &clauses, &extra) != 3 || std::string(format) != "cnf" || variables < 0 || clauses < 0)
+    {
+        return DIMACSParser::error("malformed problem line");
+    }
+
+    if (statistics.max_variable > variables)
+    {
+        return DIMACSParser::error("variable " + std::to_string(statistics.max_variable) + " exceeds the " + std::to_string(variables) + " variables of the problem line");
+    }
+
+    problem_line_found = true;
+    declared_variables = variables;
+    declared_clauses = clauses;
+
+    // Variables declared but never used still get a value
+    solver->resizeVariables(variables);
+    return true;
+}
+
+bool DIMACSParser::endInput()
+{
+    if (in_number)
+    {
+        in_number = false;
+        if (!DIMACSParser::addLiteral(negative ? -number : number))
+        {
+            return false;
+        }
+    }
+
+    if (state == problem && !DIMACSParser::parseProblemLine())
+    {
+        return false;
+    }
+
+    if (!clause.empty())
+    {
+        DIMACSParser::endClause();
+    }
+
+    return true;
+}
+
+bool DIMACSParser::finish()
+{
+    if (!DIMACSParser::endInput())
+    {
+        return false;
+    }
+
+    if (problem_line_found && statistics.clauses != declared_clauses)
+    {
+        std::cerr << "Warning: " << statistics.clauses << " clauses read, the problem line declares " << declared_clauses << ".\n";
+    }
+
+    statistics.variables = problem_line_found ? declared_variables : statistics.max_variable;
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+    statistics.seconds = statistics.bytes > 0 ? elapsed.count() : 0;
+    return true;
+}
+
+bool DIMACSParser::error(const std::string &message)
+{
+    // The parser of a chunk does not know which line of the input it is on
+    if (solver == nullptr)
+    {
+        error_message = message;
+        return false;
+    }
+
+    std::cerr << "Error on line " << line_number << ": " << message << ".\n";
+    return false;
+}
+
+void DIMACSParser::setThreads(int threads)
+{
+    this->threads = threads;
+}
+
+void DIMACSParser::setCacheWriter(CNFCacheWriter *cache_writer)
+{
+    this->cache_writer = cache_writer;
+}
+
+DIMACSStatistics DIMACSParser::getStatistics()
+{
+    return statistics;
+}
+
+void DIMACSParser::printStatistics(std::ostream &out)
+{
+    double megabytes = statistics.bytes / 1e6;
+    out << "c parsed bytes:              " << statistics.bytes << "\n";
+    out << "c parsed clauses:            " << statistics.clauses << "\n";
+    out << "c parsed literals:           " << statistics.literals << "\n";
+    out << "c parse time (s):            " << statistics.seconds << "\n";
+    out << "c parse throughput (MB/s):   " << (statistics.seconds > 0 ? megabytes / statistics.seconds : 0) << "\n";
+    if (statistics.threads > 1)
+    {
+        out << "c parse threads:             " << statistics.threads << "\n";
+        out << "c parse split time (s):      " << statistics.split_seconds << "\n";
+        out << "c parse scan time (s):       " << statistics.scan_seconds << "\n";
+        out << "c parse merge time (s):      " << statistics.merge_seconds << "\n";
+        out << "c parse wait time (s):       " << statistics.wait_seconds << "\n";
+    }
+}
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <vector>
+#include "sat_solver.h"
+
+/*
+ * The IPASIR interface of incremental SAT solvers, on top of SATSolver
+ *
+ * Clauses are added literal by literal, each clause ending with a 0, and
+ * assumptions only hold for the next ipasir_solve. Learned clauses,
+ * activities and phases carry over from one call to the next. Like the
+ * rest of the solver, the functions are defined here, so this header must
+ * be included by exactly one translation unit of a program.
+ */
+
+/*
+ * A solver behind the IPASIR interface
+ *
+ * Data members:
+ *   SATSolverOptions options
+ *       The configuration of the solver
+ *
+ *   SATSolver solver
+ *       The solver
+ *
+ *   std::vector<int> clause
+ *       The literals of the clause being added
+ */
+
+struct IPASIRSolver
+{
+    SATSolverOptions options;
+    SATSolver solver;
+    std::vector<int> clause;
+
+    IPASIRSolver() : solver(options)
+    {
+    }
+};
+
+extern "C"
+{
+    /*
+     * Gets the name of the solver
+     *
+     * @return The name and version
+     */
+
+    const char *ipasir_signature()
+    {
+        return "LTLSolver";
+    }
+
+    /*
+     * Creates a solver with an empty formula
+     *
+     * @return The solver
+     */
+
+    void *ipasir_init()
+    {
+        return new IPASIRSolver();
+    }
+
+    /*
+     * Destroys a solver
+     *
+     * @param solver The solver
+     */
+
+    void ipasir_release(void *solver)
+    {
+        delete static_cast<IPASIRSolver *>(solver);
+    }
+
+    /*
+     * Adds a literal to the clause being added, or adds the clause
+     *
+     * @param solver The solver
+     * @param lit_or_zero The literal, or 0 to end the clause
+     */
+
+    void ipasir_add(void *solver, int lit_or_zero)
+    {
+        IPASIRSolver *ipasir = static_cast<IPASIRSolver *>(solver);
+        if (lit_or_zero != 0)
+        {
+            ipasir->clause.push_back(lit_or_zero);
+            return;
+        }
+
+        ipasir->solver.addClause(ipasir->clause.data(), ipasir->clause.size());
+        ipasir->clause.clear();
+    }
+
+    /*
+     * Assumes a literal true for the next ipasir_solve
+     *
+     * @param solver The solver
+     * @param lit The literal
+     */
+
+    void ipasir_assume(void *solver, int lit)
+    {
+        static_cast<IPASIRSolver *>(solver)->solver.assume(lit);
+    }
+
+    /*
+     * Solves the formula under the assumptions
+     *
+     * @param solver The solver
+     * @return 10 if satisfied, 20 if unsatisfied, 0 if terminated
+     */
+
+    int ipasir_solve(void *solver)
+    {
+        SATSolver &sat_solver = static_cast<IPASIRSolver *>(solver)->solver;
+        sat_solver.solve();
+        SAT result = sat_solver.getResult();
+        return result == satisfied ? 10 : result == unsatisfied ? 20 : 0;
+    }
+
+    /*
+     * Gets the value of a literal after ipasir_solve returned 10
+     *
+     * @param solver The solver
+     * @param lit The literal
+     * @return lit if it is true, -lit if it is false
+     */
+
+    int ipasir_val(void *solver, int lit)
+    {
+        return static_cast<IPASIRSolver *>(solver)->solver.value(lit);
+    }
+
+    /*
+     * Checks whether an assumption takes part in the refutation after
+     * ipasir_solve returned 20
+     *
+     * @param solver The solver
+     * @param lit The assumption
+     * @return 1 if the assumption failed, 0 otherwise
+     */
+
+    int ipasir_failed(void *solver, int lit)
+    {
+        return static_cast<IPASIRSolver *>(solver)->solver.failed(lit) ? 1 : 0;
+    }
+
+    /*
+     * Makes ipasir_solve give up once a callback returns a nonzero value
+     *
+     * @param solver The solver
+     * @param data The argument of the callback
+     * @param terminate The callback, or nullptr to never give up
+     */
+
+    void ipasir_set_terminate(void *solver, void *data, int (*terminate)(void *data))
+    {
+        static_cast<IPASIRSolver *>(solver)->solver.setTerminateCallback(terminate, data);
+    }
+
+    /*
+     * Passes the learned clauses up to a size to a callback
+     *
+     * @param solver The solver
+     * @param data The first argument of the callback
+     * @param max_length The largest clause passed
+     * @param learn The callback, or nullptr for none
+     */
+
+    void ipasir_set_learn(void *solver, void *data, int max_length, void (*learn)(void *data, int *clause))
+    {
+        static_cast<IPASIRSolver *>(solver)->solver.setLearnCallback(learn, data, max_length);
+    }
+}
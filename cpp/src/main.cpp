@@ -1,91 +1,219 @@
 #include "sat_solver.h"
+#include "dimacs_parser.h"
+#include "cube_and_conquer.h"
+#include "portfolio.h"
 #include <iostream>
-#include <fstream>
-#include <sstream>
+#include <memory>
+#include <stdexcept>
+#include <thread>
 
 /*
- *  Parses a DIMACS input file and stores the formula in a vector of vectors.
+ * Main function.
  */
 
-bool parseDIMACS(std::string &dimacs_input, std::vector<std::vector<int>> &formula)
+int main(int argc, char *argv[])
 {
-    std::istringstream iss(dimacs_input);
-    std::string line;
+    std::string input_path;
+    int input_fd = -1;
+    std::string cache_path;
+    std::string convert_path;
+    bool print_statistics = false;
+    int parse_threads = std::max(1u, std::thread::hardware_concurrency());
+    int solve_threads = 1;
+    bool cubes = false;
+    SATSolverOptions options;
 
-    while (std::getline(iss, line))
+    for (int i = 1; i < argc; i++)
     {
-        if (line[0] == 'c' || line.empty())
+        std::string argument = argv[i];
+        if (argument == "--stats")
         {
-            continue;
+            print_statistics = true;
         }
-        else if (line[0] == 'p')
+        else if (argument == "--restarts=luby")
         {
-            std::istringstream problem_line(line);
-            std::string token;
-            problem_line >> token; // Ignore 'p'
-            problem_line >> token; // Ignore 'cnf'
-
-            int num_variables, num_clauses;
+            options.restart_policy = restart_luby;
+        }
+        else if (argument == "--restarts=ema")
+        {
+            options.restart_policy = restart_ema;
+        }
+        else if (argument == "--restarts=none")
+        {
+            options.restart_policy = restart_none;
+        }
+        else if (argument.rfind("--cache=", 0) == 0)
+        {
+            cache_path = argument.substr(8);
+        }
+        else if (argument.rfind("--convert=", 0) == 0)
+        {
+            convert_path = argument.substr(10);
+        }
+        else if (argument.rfind("--parse-threads=", 0) == 0)
+        {
+            parse_threads = std::max(1, atoi(argument.c_str() + 16));
+        }
+        else if (argument.rfind("--threads=", 0) == 0)
+        {
+            solve_threads = std::max(1, atoi(argument.c_str() + 10));
+        }
+        else if (argument == "--cubes")
+        {
+            cubes = true;
+        }
+        else if (argument.rfind("--fd=", 0) == 0 && input_path.empty())
+        {
+            input_fd = atoi(argument.c_str() + 5);
+            input_path = "fd " + std::to_string(input_fd);
+        }
+        else if (input_path.empty())
+        {
+            input_path = argument;
 
-            if (!(problem_line >> num_variables >> num_clauses))
+            // "-" reads the formula from stdin
+            if (input_path == "-")
             {
-                std::cerr << "Error parsing problem line.\n";
-                return false;
+                input_fd = STDIN_FILENO;
+                input_path = "stdin";
             }
         }
         else
         {
-            std::istringstream clause_line(line);
-            std::vector<int> clause;
-            int literal = 1;
-            while (clause_line >> literal && literal != 0)
-            {
-                clause.push_back(literal);
-            }
-            formula.push_back(clause);
+            input_path.clear();
+            break;
         }
     }
 
-    return true;
-}
-
-/*
- * Main function.
- */
-
-int main(int argc, char *argv[])
-{
-    if (argc != 2)
+    if (input_path.empty())
     {
-        std::cout << "Usage: " << argv[0] << " '<DIMACS input>'\n";
+        std::cout << "Usage: " << argv[0] << " [--stats] [--restarts=luby|ema|none] [--cache=<file>] [--convert=<file>] [--parse-threads=N] [--threads=N] [--cubes] ('<DIMACS input>' | - | --fd=N)\n";
         return 1;
     }
 
-    // std::string dimacs_input = argv[1];
-
-    std::string dimacs_input;
-    std::ifstream infile(argv[1]);
-    std::stringstream buffer;
-    buffer << infile.rdbuf();
-    dimacs_input = buffer.str();
+    // A formula too large for the clause arena stops the solver with an
+    // error instead of a wrong answer
+    try
+    {
+        // The parser adds the clauses straight to the solver as it reads them
+        SATSolver solver(options);
+        DIMACSParser parser(solver);
+        parser.setThreads(parse_threads);
+        CNFCacheReader cache_reader;
+        CNFCacheWriter cache_writer;
+        bool loaded;
 
-    std::vector<std::vector<int>> formula;
+        // A binary cache given as input, or a cache made from the current input,
+        // replaces parsing; streamed inputs can only be converted
+        bool streamed = input_fd >= 0;
+        if (streamed)
+        {
+            cache_path.clear();
+        }
 
-    if (parseDIMACS(dimacs_input, formula))
-    {
-        SATSolver solver(formula);
+        std::string load_path = !streamed && CNFCacheReader::isCache(input_path) ? input_path : "";
+        if (load_path.empty() && !cache_path.empty() && CNFCacheReader::isFresh(cache_path, input_path))
+        {
+            load_path = cache_path;
+        }
 
-        if (solver.solve())
+        if (!load_path.empty())
         {
-            std::cout << "SAT\n";
+            loaded = cache_reader.load(load_path, solver);
+            if (loaded && print_statistics)
+            {
+                cache_reader.printStatistics(std::cerr);
+            }
         }
         else
         {
-            std::cout << "UNSAT\n";
+            // Otherwise, the clauses are copied to a new cache while parsing
+            std::string write_path = convert_path.empty() ? cache_path : convert_path;
+            bool writing = !write_path.empty() && cache_writer.open(write_path, input_path);
+            if (writing)
+            {
+                parser.setCacheWriter(&cache_writer);
+            }
+
+            loaded = streamed ? parser.parseDescriptor(input_fd, input_path) : parser.parseFile(input_path);
+            bool written = loaded && writing && cache_writer.close(parser.getStatistics().variables);
+
+            // A failed cache only matters to the converter mode
+            if (!convert_path.empty() && !written)
+            {
+                loaded = false;
+            }
+
+            // Report the parse before solving, which may take much longer
+            if (loaded && print_statistics)
+            {
+                parser.printStatistics(std::cerr);
+            }
         }
 
-        return 0;
-    }
+        // The converter mode stops once the cache is written
+        if (!convert_path.empty())
+        {
+            return loaded ? 0 : 1;
+        }
 
-    return 1;
-}
\ No newline at end of file
+        if (loaded)
+        {
+            // Several threads race differently configured solvers on the
+            // formula parsed above, or split it into cubes solved in parallel;
+            // only the selected mode is built, as each one allocates its own
+            // clause exchange
+            std::unique_ptr<Portfolio> portfolio;
+            std::unique_ptr<CubeAndConquer> cube_and_conquer;
+            bool satisfiable;
+            if (cubes)
+            {
+                cube_and_conquer.reset(new CubeAndConquer(solver, options, solve_threads));
+                satisfiable = cube_and_conquer->solve();
+            }
+            else if (solve_threads > 1)
+            {
+                portfolio.reset(new Portfolio(solver, options, solve_threads));
+                satisfiable = portfolio->solve();
+            }
+            else
+            {
+                satisfiable = solver.solve();
+            }
+            if (satisfiable)
+            {
+                std::cout << "SAT\n";
+            }
+            else
+            {
+                std::cout << "UNSAT\n";
+            }
+
+            // Statistics go to stderr so that stdout only holds the answer
+            if (print_statistics)
+            {
+                if (cubes)
+                {
+                    cube_and_conquer->printStatistics(std::cerr);
+                }
+                else if (solve_threads > 1)
+                {
+                    portfolio->printStatistics(std::cerr);
+                }
+                else
+                {
+                    solver.printStatistics(std::cerr);
+                }
+            }
+
+            return 0;
+        }
+
+        return 1;
+    }
+    catch (const std::length_error &error)
+    {
+        std::cerr << "Error: " << error.what() << ".\n";
+        return 1;
+    }
+}
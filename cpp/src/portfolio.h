@@ -0,0 +1,310 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "clause_exchange.h"
+#include "sat_solver.h"
+
+/*
+ * Runs several differently configured solvers on the same formula, one per
+ * thread, and keeps the answer of the first one to finish
+ *
+ * The formula is parsed once into the solver of worker 0, which then moves
+ * its original clauses to a base arena that is only read from then on.
+ * Every worker reads the original clauses from that arena and keeps in an
+ * arena of its own only the clauses it learns or changes, so the memory
+ * grows with the learned clauses rather than with a copy of the formula
+ * per worker; the watch lists remain per worker. The other workers take
+ * the clause list and the binary clauses of worker 0 on their own threads,
+ * and worker 0 only starts solving once they all have. Unless the sharing
+ * option is off, the workers also send each other their short learned
+ * clauses through a lock-free exchange.
+ *
+ * Member functions:
+ *   SATSolverOptions diversify(SATSolverOptions &options, int worker)
+ *       Derives the configuration of a worker from the given one; worker 0
+ *       keeps it unchanged
+ *       @param options The configuration given by the user
+ *       @param worker The index of the worker
+ *       @return The configuration of the worker
+ *
+ *   void run(int worker)
+ *       Builds the solver of a worker if needed, solves, and reports the
+ *       answer if it is the first one
+ *       @param worker The index of the worker
+ *
+ *   bool solve()
+ *       Starts every worker and waits for all of them; once one of them
+ *       answers, the others are asked to stop
+ *       @return true if the formula is satisfied
+ *               false if the formula is unsatisfied
+ *       @throws The first exception thrown by a worker, such as
+ *               std::length_error for a full clause arena
+ *
+ *   std::vector<std::pair<int, bool>> getAssignment()
+ *       Gets the model found by the worker that answered
+ *       @return The value of every variable, sorted by variable
+ *
+ *   void printStatistics(std::ostream &out)
+ *       Prints the clauses shared by every worker, which worker answered
+ *       and its statistics
+ *       @param out The stream to print to
+ *
+ * Data members:
+ *   SATSolver &formula
+ *       The solver holding the parsed formula, which is also worker 0
+ *
+ *   SATSolverOptions options
+ *       The configuration given by the user
+ *
+ *   int thread_count
+ *       The number of workers
+ *
+ *   std::vector<std::unique_ptr<SATSolver>> solvers
+ *       The solvers of the workers other than worker 0, indexed by worker
+ *       (the entry of worker 0 stays empty)
+ *
+ *   ClauseExchange exchange
+ *       The learned clauses sent from each worker to the others
+ *
+ *   std::atomic<bool> terminate
+ *       Set once a worker has answered, which makes the others give up
+ *
+ *   std::mutex mutex
+ *       Guards copies_left and winner
+ *
+ *   std::condition_variable copies_done
+ *       Signalled when the last worker has taken the formula
+ *
+ *   int copies_left
+ *       The number of workers still taking the formula
+ *
+ *   int winner
+ *       The worker that answered, -1 if there is none yet
+ *
+ *   std::exception_ptr failure
+ *       The first exception thrown by a worker, which stops the others
+ */
+
+class Portfolio
+{
+private:
+    // Member functions
+    static SATSolverOptions diversify(SATSolverOptions &, int);
+    void run(int);
+
+    // Data members
+    SATSolver &formula;
+    SATSolverOptions options;
+    int thread_count;
+    std::vector<std::unique_ptr<SATSolver>> solvers;
+    ClauseExchange exchange;
+    std::atomic<bool> terminate;
+    std::mutex mutex;
+    std::condition_variable copies_done;
+    int copies_left;
+    int winner;
+    std::exception_ptr failure;
+
+public:
+    // Constructors
+    Portfolio(SATSolver &, SATSolverOptions &, int);
+
+    // Member functions
+    bool solve();
+    std::vector<std::pair<int, bool>> getAssignment();
+    void printStatistics(std::ostream &);
+};
+
+Portfolio::Portfolio(SATSolver &formula, SATSolverOptions &options, int thread_count) : formula(formula), exchange(std::max(1, thread_count), options.share_ring_size), terminate(false)
+{
+    this->options = options;
+    this->thread_count = std::max(1, thread_count);
+    this->copies_left = 0;
+    this->winner = -1;
+}
+
+SATSolverOptions Portfolio::diversify(SATSolverOptions &options, int worker)
+{
+    SATSolverOptions diversified = options;
+    if (worker == 0)
+    {
+        return diversified;
+    }
+
+    // Every worker searches differently from the start
+    diversified.seed = options.seed + worker;
+
+    // Half of the workers restart on the Luby schedule instead of the LBD
+    // averages
+    if (worker % 2 == 1)
+    {
+        diversified.restart_policy = options.restart_policy == restart_luby ? restart_ema : restart_luby;
+    }
+
+    // Half of the workers start from the other phase
+    if (worker % 4 >= 2)
+    {
+        diversified.initial_phase = 1 - options.initial_phase;
+    }
+
+    // The other settings cycle through a few variants of their own
+    switch (worker % 6)
+    {
+    case 1:
+        diversified.target_phases = !options.target_phases;
+        break;
+    case 2:
+        diversified.rephase_interval = options.rephase_interval * 4;
+        diversified.tier2_lbd = options.tier2_lbd + 2;
+        break;
+    case 3:
+        diversified.elimination = false;
+        diversified.vivification = false;
+        break;
+    case 4:
+        diversified.trail_reuse = !options.trail_reuse;
+        diversified.reduce_interval = options.reduce_interval * 2;
+        break;
+    case 5:
+        diversified.walk_flips = options.walk_flips * 10;
+        diversified.probing_effort = options.probing_effort * 2;
+        break;
+    }
+
+    return diversified;
+}
+
+void Portfolio::run(int worker)
+{
+    // An exception stops every worker and is rethrown by solve()
+    auto fail = [this]
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (failure == nullptr)
+        {
+            failure = std::current_exception();
+        }
+        terminate.store(true);
+    };
+
+    SATSolver *solver = &formula;
+    if (worker != 0)
+    {
+        // Share the formula, then let worker 0 start once nobody reads it
+        bool copied = true;
+        try
+        {
+            SATSolverOptions worker_options = Portfolio::diversify(options, worker);
+            solvers[worker].reset(new SATSolver(worker_options));
+            solver = solvers[worker].get();
+            solver->shareBaseClauses(formula);
+        }
+        catch (...)
+        {
+            fail();
+            copied = false;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--copies_left == 0)
+            {
+                copies_done.notify_all();
+            }
+        }
+        if (!copied)
+        {
+            return;
+        }
+    }
+    else
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        copies_done.wait(lock, [this]
+                         { return copies_left == 0; });
+    }
+
+    solver->setTerminateFlag(&terminate);
+    if (options.sharing && thread_count > 1)
+    {
+        solver->setClauseExchange(&exchange, worker);
+    }
+    try
+    {
+        solver->solve();
+    }
+    catch (...)
+    {
+        fail();
+        return;
+    }
+
+    // The first worker with an answer wins and stops the others
+    if (solver->getResult() != normal)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (winner == -1)
+        {
+            winner = worker;
+            terminate.store(true);
+        }
+    }
+}
+
+bool Portfolio::solve()
+{
+    solvers.clear();
+    solvers.resize(thread_count);
+    formula.moveClausesToBase();
+    copies_left = thread_count - 1;
+    winner = -1;
+    failure = nullptr;
+    terminate.store(false);
+
+    std::vector<std::thread> threads;
+    for (int worker = 0; worker < thread_count; worker++)
+    {
+        threads.emplace_back(&Portfolio::run, this, worker);
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    if (failure != nullptr)
+    {
+        std::rethrow_exception(failure);
+    }
+
+    SATSolver &answer = winner > 0 ? *solvers[winner] : formula;
+    return answer.getResult() == satisfied;
+}
+
+std::vector<std::pair<int, bool>> Portfolio::getAssignment()
+{
+    SATSolver &answer = winner > 0 ? *solvers[winner] : formula;
+    return answer.getAssignment();
+}
+
+void Portfolio::printStatistics(std::ostream &out)
+{
+    out << "c portfolio threads:         " << thread_count << "\n";
+    out << "c answering thread:          " << winner << "\n";
+
+    // Clauses exported, imported and imported then used by each worker
+    for (int worker = 0; worker < thread_count; worker++)
+    {
+        SATSolver &solver = worker > 0 ? *solvers[worker] : formula;
+        SATSolverStatistics statistics = solver.getStatistics();
+        out << "c thread " << worker << " shared clauses:   " << statistics.exported_clauses << " exported, " << statistics.imported_clauses << " imported, " << statistics.imported_clauses_used << " used\n";
+    }
+
+    SATSolver &answer = winner > 0 ? *solvers[winner] : formula;
+    answer.printStatistics(out);
+}
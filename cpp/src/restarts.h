@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cmath>
+
+/*
+ * The restart policies of the SAT solver
+ *   restart_none: never restart
+ *   restart_luby: restart after luby(2, i) * luby_unit conflicts
+ *   restart_ema: restart when the recent LBDs of learned clauses are
+ *                clearly worse than the long-term average (Glucose style)
+ */
+
+enum RestartPolicy
+{
+    restart_none,
+    restart_luby,
+    restart_ema
+};
+
+/*
+ * Computes the x-th element of the Luby sequence scaled by powers of y
+ *
+ * @param y The base, 2 for the classic 1 1 2 1 1 2 4 ... sequence
+ * @param x The index of the element, starting from 0
+ * @return y raised to the power of the x-th element's exponent
+ */
+
+double luby(double y, int x)
+{
+    // Find the finite subsequence that contains the index, and its size
+    int size = 1;
+    int sequence = 0;
+    while (size < x + 1)
+    {
+        sequence++;
+        size = 2 * size + 1;
+    }
+
+    // Descend into the subsequences until the index is the last element
+    while (size - 1 != x)
+    {
+        size = (size - 1) >> 1;
+        sequence--;
+        x = x % size;
+    }
+
+    return std::pow(y, sequence);
+}
+
+/*
+ * An exponential moving average
+ *
+ * The smoothing factor starts at 1 and shrinks as 1 / count until it
+ * reaches alpha, so that the first values are not biased towards 0.
+ *
+ * Member functions:
+ *   void update(double sample)
+ *       Adds a new sample to the average
+ *       @param sample The sample
+ *
+ * Data members:
+ *   double value
+ *       The current average
+ *
+ *   double alpha
+ *       The smoothing factor
+ *
+ *   long long count
+ *       The number of samples seen
+ */
+
+struct ExponentialMovingAverage
+{
+    double value = 0;
+    double alpha = 0;
+    long long count = 0;
+
+    void update(double sample)
+    {
+        count++;
+        double factor = 1.0 / count > alpha ? 1.0 / count : alpha;
+        value += factor * (sample - value);
+    }
+};
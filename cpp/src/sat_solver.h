@@ -1,7 +1,17 @@
+#pragma once
+
 #include <iostream>
 #include <vector>
 #include <algorithm>
+#include <atomic>
+#include <climits>
 #include <iostream>
+#include "clause_arena.h"
+#include "clause_exchange.h"
+#include "restarts.h"
+#include "variable_heap.h"
+#include "walker.h"
+#include "watcher.h"
 
 enum SAT
 {
@@ -10,487 +20,5111 @@ enum SAT
     normal
 };
 
+/*
+ * Tunable parameters of the SAT solver
+ *
+ * Data members:
+ *   int strategy
+ *       The decision strategy
+ *       0: basic strategy
+ *       1: VSIDS
+ *
+ *   bool minimization
+ *       Whether learned clauses are minimized recursively
+ *
+ *   bool binary_minimization
+ *       Whether learned clauses are strengthened with the binary clauses
+ *       of their asserting literal
+ *
+ *   int binary_minimization_size
+ *       The largest learned clause strengthened with binary clauses
+ *
+ *   int core_lbd
+ *       The largest LBD of the learned clauses kept forever
+ *
+ *   int tier2_lbd
+ *       The largest LBD of the learned clauses kept while they are used
+ *
+ *   int reduce_interval
+ *       The number of conflicts before the first reduction of the
+ *       learned clauses
+ *
+ *   int reduce_increment
+ *       The growth of the interval after every reduction
+ *
+ *   double clause_decay
+ *       The decay factor of the learned clause activities
+ *
+ *   RestartPolicy restart_policy
+ *       When to restart (see RestartPolicy)
+ *
+ *   int luby_unit
+ *       The number of conflicts of a Luby interval of length 1
+ *
+ *   double restart_fast_alpha
+ *       The smoothing factor of the fast LBD average
+ *
+ *   double restart_slow_alpha
+ *       The smoothing factor of the slow LBD average
+ *
+ *   double restart_margin
+ *       How much worse than the slow LBD average the fast one must be to
+ *       trigger a restart
+ *
+ *   int restart_min_conflicts
+ *       The least number of conflicts between two EMA restarts
+ *
+ *   double restart_block_margin
+ *       How much longer than its average the trail must be at a conflict
+ *       to postpone the next EMA restart
+ *
+ *   int restart_block_conflicts
+ *       The number of conflicts before restarts may be postponed
+ *
+ *   bool trail_reuse
+ *       Whether restarts keep the decision levels whose decisions are
+ *       still more active than the next decision
+ *
+ *   int initial_phase
+ *       The phase of a variable before it is first assigned (1 or 0)
+ *
+ *   bool phase_saving
+ *       Whether decisions reuse the last value of the variable
+ *
+ *   bool target_phases
+ *       Whether decisions prefer the value the variable had on the longest
+ *       conflict-free trail since the last rephase
+ *
+ *   int rephase_interval
+ *       The number of conflicts before the first rephase; the k-th
+ *       rephase happens k intervals after the previous one
+ *
+ *   long long walk_flips
+ *       The largest number of flips of a local search rephase
+ *
+ *   unsigned seed
+ *       The seed of the random choices
+ *
+ *   bool elimination
+ *       Whether variables are eliminated by resolution before the search
+ *
+ *   int elimination_clause_size
+ *       The largest resolvent an elimination may add
+ *
+ *   int elimination_occurrences
+ *       The largest number of clauses containing either literal of an
+ *       eliminated variable
+ *
+ *   long long elimination_effort
+ *       The number of literals and occurrences elimination may visit
+ *       before it gives up
+ *
+ *   bool subsumption
+ *       Whether subsumed clauses are removed and clauses are strengthened
+ *       by self-subsuming resolution, before and during the search
+ *
+ *   int subsumption_clause_size
+ *       The largest clause used to subsume or strengthen other clauses
+ *
+ *   long long subsumption_effort
+ *       The number of literals and occurrences a subsumption round may
+ *       visit before it gives up
+ *
+ *   int subsumption_interval
+ *       The number of conflicts before the first inprocessing round during
+ *       the search; the k-th round happens k intervals after the previous one
+ *
+ *   bool substitution
+ *       Whether the literals of each strongly connected component of the
+ *       binary implication graph are replaced by one of them, before the
+ *       search and at every inprocessing round
+ *
+ *   bool probing
+ *       Whether the roots of the binary implication graph are probed during
+ *       the search to find failed literals, common implications and hyper
+ *       binary resolvents
+ *
+ *   int probing_interval
+ *       The number of conflicts before the first probing round; the k-th
+ *       round happens k intervals after the previous one
+ *
+ *   double probing_effort
+ *       The number of propagations a probing round may make, relative to
+ *       the search propagations since the previous round
+ *
+ *   bool vivification
+ *       Whether clauses are shortened during the search by propagating the
+ *       negations of their literals
+ *
+ *   int vivification_interval
+ *       The number of conflicts before the first vivification round; the
+ *       k-th round happens k intervals after the previous one
+ *
+ *   double vivification_effort
+ *       The number of propagations a vivification round may make, relative
+ *       to the search propagations since the previous round
+ *
+ *   bool sharing
+ *       Whether the solvers of a portfolio exchange their learned clauses
+ *
+ *   int share_clause_size
+ *       The largest learned clause exported, capped at SHARED_CLAUSE_SIZE
+ *
+ *   int share_lbd, share_max_lbd
+ *       The bounds of the LBD limit of exported clauses, which starts at
+ *       share_lbd; units are always exported
+ *
+ *   int share_interval
+ *       The number of conflicts between two adjustments of the LBD limit
+ *
+ *   int share_target
+ *       The number of clauses to export per interval: the LBD limit goes
+ *       up after an interval with fewer than half of them, and down after
+ *       one with more
+ *
+ *   int share_ring_size
+ *       The number of exported clauses each solver keeps for the others
+ *
+ *   int lookahead_candidates
+ *       The number of variables whose two literals a lookahead propagates
+ *
+ *   long long cube_conflicts
+ *       The number of conflicts a cube is searched for before checking
+ *       whether it must be split for an idle worker
+ */
+
+struct SATSolverOptions
+{
+    int strategy = 1;
+    bool minimization = true;
+    bool binary_minimization = true;
+    int binary_minimization_size = 30;
+    int core_lbd = 2;
+    int tier2_lbd = 6;
+    int reduce_interval = 2000;
+    int reduce_increment = 300;
+    double clause_decay = 0.999;
+    RestartPolicy restart_policy = restart_ema;
+    int luby_unit = 100;
+    double restart_fast_alpha = 0.03;
+    double restart_slow_alpha = 1e-5;
+    double restart_margin = 1.1;
+    int restart_min_conflicts = 2;
+    double restart_block_margin = 1.4;
+    int restart_block_conflicts = 10000;
+    bool trail_reuse = true;
+    int initial_phase = 1;
+    bool phase_saving = true;
+    bool target_phases = true;
+    int rephase_interval = 1000;
+    long long walk_flips = 100000;
+    unsigned seed = 0;
+    bool elimination = true;
+    int elimination_clause_size = 20;
+    int elimination_occurrences = 1000;
+    long long elimination_effort = 20000000;
+    bool subsumption = true;
+    int subsumption_clause_size = 100;
+    long long subsumption_effort = 10000000;
+    int subsumption_interval = 10000;
+    bool substitution = true;
+    bool probing = true;
+    int probing_interval = 3000;
+    double probing_effort = 0.1;
+    bool vivification = true;
+    int vivification_interval = 4000;
+    double vivification_effort = 0.1;
+    bool sharing = true;
+    int share_clause_size = 30;
+    int share_lbd = 2;
+    int share_max_lbd = 8;
+    int share_interval = 1000;
+    int share_target = 100;
+    int share_ring_size = 4096;
+    int lookahead_candidates = 50;
+    long long cube_conflicts = 5000;
+};
+
+/*
+ * Counters collected while solving
+ *
+ * Data members:
+ *   long long decisions
+ *       The number of decisions
+ *
+ *   long long propagations
+ *       The number of literals propagated
+ *
+ *   long long conflicts
+ *       The number of conflicts
+ *
+ *   long long learned_literals
+ *       The number of literals in learned clauses after minimization
+ *
+ *   long long minimized_literals
+ *       The number of literals removed by recursive minimization
+ *
+ *   long long binary_minimized_literals
+ *       The number of literals removed with binary clauses
+ *
+ *   long long reductions
+ *       The number of reductions of the learned clauses
+ *
+ *   long long deleted_clauses
+ *       The number of learned clauses deleted by reductions
+ *
+ *   long long promoted_clauses
+ *       The number of learned clauses moved to a better tier after their
+ *       LBD dropped in a conflict
+ *
+ *   long long restarts
+ *       The number of restarts
+ *
+ *   long long blocked_restarts
+ *       The number of times a restart was postponed because of a long trail
+ *
+ *   long long reused_levels
+ *       The number of decision levels kept by restarts
+ *
+ *   long long rephases
+ *       The number of times the saved phases were reset
+ *
+ *   long long walk_flips
+ *       The number of flips made by local search rephases
+ *
+ *   long long eliminated_variables
+ *       The number of variables eliminated by resolution
+ *
+ *   long long eliminated_clauses
+ *       The number of clauses removed with the eliminated variables
+ *
+ *   long long resolvents
+ *       The number of resolvents added in their place
+ *
+ *   long long inprocessing_rounds
+ *       The number of times the search stopped to simplify the clauses
+ *
+ *   long long subsumption_rounds
+ *       The number of subsumption rounds
+ *
+ *   long long subsumed_clauses
+ *       The number of clauses removed because another clause subsumes them
+ *
+ *   long long strengthened_clauses
+ *       The number of times a clause lost a literal by self-subsuming
+ *       resolution
+ *
+ *   long long substituted_variables
+ *       The number of variables replaced by an equivalent literal
+ *
+ *   long long probing_rounds
+ *       The number of probing rounds
+ *
+ *   long long probed_literals
+ *       The number of literals assigned by themselves and propagated
+ *
+ *   long long probing_propagations
+ *       The number of literals propagated while probing, also counted in
+ *       propagations
+ *
+ *   long long failed_literals
+ *       The number of probed literals whose propagation was conflicting,
+ *       so that their negation became a unit
+ *
+ *   long long implied_units
+ *       The number of literals implied by both values of a probed variable
+ *
+ *   long long hyper_binary_resolvents
+ *       The number of binary clauses learned from the longer clauses
+ *       propagating while probing
+ *
+ *   long long vivification_rounds
+ *       The number of vivification rounds
+ *
+ *   long long vivified_clauses
+ *       The number of clauses whose literals were propagated
+ *
+ *   long long vivification_propagations
+ *       The number of literals propagated while vivifying, also counted in
+ *       propagations
+ *
+ *   long long vivified_literals
+ *       The number of literals removed by vivification
+ *
+ *   long long vivification_removed_clauses
+ *       The number of learned clauses removed because the other clauses
+ *       imply them
+ *
+ *   long long exported_clauses
+ *       The number of learned clauses sent to the other solvers
+ *
+ *   long long imported_clauses
+ *       The number of clauses received from the other solvers and added
+ *
+ *   long long imported_clauses_used
+ *       The number of added clauses of three or more literals that later
+ *       took part in a conflict
+ *
+ *   long long duplicate_shared_clauses
+ *       The number of clauses not exported or not added because the same
+ *       clause was already sent or received
+ *
+ *   long long lost_shared_clauses
+ *       The number of clauses of the other solvers overwritten before they
+ *       were received
+ *
+ *   long long lookaheads
+ *       The number of lookaheads
+ *
+ *   long long lookahead_propagations
+ *       The number of literals propagated by lookaheads, also counted in
+ *       propagations
+ *
+ *   long long restored_clauses
+ *       The number of clauses removed by elimination or substitution and
+ *       added back because a new clause or an assumption used one of their
+ *       variables
+ */
+
+struct SATSolverStatistics
+{
+    long long decisions = 0;
+    long long propagations = 0;
+    long long conflicts = 0;
+    long long learned_literals = 0;
+    long long minimized_literals = 0;
+    long long binary_minimized_literals = 0;
+    long long reductions = 0;
+    long long deleted_clauses = 0;
+    long long promoted_clauses = 0;
+    long long restarts = 0;
+    long long blocked_restarts = 0;
+    long long reused_levels = 0;
+    long long rephases = 0;
+    long long walk_flips = 0;
+    long long eliminated_variables = 0;
+    long long eliminated_clauses = 0;
+    long long resolvents = 0;
+    long long inprocessing_rounds = 0;
+    long long subsumption_rounds = 0;
+    long long subsumed_clauses = 0;
+    long long strengthened_clauses = 0;
+    long long substituted_variables = 0;
+    long long probing_rounds = 0;
+    long long probed_literals = 0;
+    long long probing_propagations = 0;
+    long long failed_literals = 0;
+    long long implied_units = 0;
+    long long hyper_binary_resolvents = 0;
+    long long vivification_rounds = 0;
+    long long vivified_clauses = 0;
+    long long vivification_propagations = 0;
+    long long vivified_literals = 0;
+    long long vivification_removed_clauses = 0;
+    long long exported_clauses = 0;
+    long long imported_clauses = 0;
+    long long imported_clauses_used = 0;
+    long long duplicate_shared_clauses = 0;
+    long long lost_shared_clauses = 0;
+    long long lookaheads = 0;
+    long long lookahead_propagations = 0;
+    long long restored_clauses = 0;
+};
+
 /*
  * A class for the CDCL-based SAT solver
  *
  * Member functions:
- *   int get_literal_index(int &literal)
- *      Gets the index of the given literal
- *      @param literal The literal
- *      @return The index of the literal
- *             -1 if the literal is not in the vector
- *
- *   int unitPropagation(int &decision_level)
- *       Propagates unit clauses
- *       @param decision_level The current decision level
- *       @return SAT::satisfied if the formula is satisfied
- *               SAT::unsatisfied if the formula is unsatisfied
- *               SAT::normal if the formula is normal
+ *   void initialize(std::vector<std::vector<int>> &formula, int variable_count)
+ *       Sizes the per-variable arrays and the watch lists, normalizes
+ *       the clauses, stores them in the arena and watches them
+ *       Binary clauses are only stored in the watch lists
+ *       @param formula The formula
+ *       @param variable_count The number of variables
+ *
+ *   int watchIndex(int literal)
+ *       Gets the index of the watch list of the given literal
+ *       @param literal The literal
+ *       @return 2 * |literal| for positive literals,
+ *               2 * |literal| + 1 for negative literals
+ *
+ *   int literalValue(int literal)
+ *       Gets the value of the given literal under the current assignment
+ *       @param literal The literal
+ *       @return 1 if the literal is true, 0 if it is false,
+ *               -1 if it is unassigned
+ *
+ *   int decisionLevel()
+ *       Gets the current decision level
+ *       @return The number of decisions on the trail
+ *
+ *   void newDecisionLevel()
+ *       Opens a new decision level at the end of the trail
+ *
+ *   void assignLiteral(int literal, ClauseRef antecedent_clause)
+ *       Makes the given literal true at the current decision level and
+ *       pushes it on the trail
+ *       @param literal The literal
+ *       @param antecedent_clause The clause that implied the literal
+ *                                (CLAUSE_UNDEF for decisions, a
+ *                                binaryReason for binary clauses)
+ *
+ *   void watchClause(ClauseRef clause_ref)
+ *       Adds the first two literals of the clause to their watch lists,
+ *       each with the other one as blocker; a ternary clause goes to the
+ *       ternary watch lists of its three literals instead, and a base
+ *       clause records the positions of its watched literals in its state
+ *       @param clause_ref The reference of the clause in the arena
+ *
+ *   void watchBinaryClause(int first, int second, bool learnt)
+ *       Adds an implicit binary clause to the watch lists of its literals
+ *       @param first, second The literals of the clause
+ *       @param learnt Whether the clause is learned
+ *
+ *   int *reasonLiterals(ClauseRef reason_ref, int implied_literal, int &size)
+ *       Gets the literals of a reason or of a conflict, whether the clause
+ *       is in the arena or binary
+ *       @param reason_ref The reason, or the conflict from unitPropagation
+ *       @param implied_literal The literal implied by the reason, 0 for
+ *                              a conflict
+ *       @param size Set to the number of literals
+ *       @return The literals, the implied literal first; the literals of
+ *               a ternary reason are reordered in place to get there, and
+ *               those of a base clause are copied to base_reason
+ *
+ *   void removeSatisfied(std::vector<ClauseRef> &clause_refs)
+ *       Frees the clauses that are satisfied at decision level 0 and drops
+ *       them from the given list
+ *       @param clause_refs The original or the learned clauses
+ *
+ *   void purgeWatches()
+ *       Drops the watches of freed clauses and of binary clauses satisfied
+ *       at decision level 0 from every watch list and ternary watch list
+ *
+ *   void simplifyDatabase()
+ *       Removes the clauses satisfied by new decision level 0 assignments
+ *       and collects garbage if enough of the arena is wasted
+ *
+ *   void garbageCollect()
+ *       Compacts the live clauses into a new arena and rewrites the watch
+ *       lists, the reasons and the clause lists to the new references;
+ *       freed clauses are dropped from the clause lists
+ *
+ *   ClauseRef unitPropagation()
+ *       Propagates every literal on the trail that has not been propagated
+ *       yet, visiting only the clauses watching the falsified literal
+ *       Binary clauses, ternary clauses and clauses with a true blocker
+ *       are handled without reading the arena
+ *       @return The reference of the conflicting clause, BINARY_REASON
+ *               for a binary clause (see binary_conflict)
+ *               CLAUSE_UNDEF if there is no conflict
  *
  *   int chooseLiteral()
  *       Chooses a literal
+ *       With VSIDS, unassigned variables are popped from the activity heap
+ *       The sign comes from the target phase if there is one, otherwise
+ *       from the saved phase
  *       @return The chosen literal
  *
- *   int analyzeConflict(int &decision_level)
- *       Analyzes the conflict clause
- *       @param decision_level The current decision level
+ *   void updateTargetPhases(int consistent_size)
+ *       Saves the values of a conflict-free trail prefix as target phases
+ *       if it is the longest since the last rephase, and as best phases if
+ *       it is the longest since best phases were last used
+ *       @param consistent_size The size of the conflict-free trail prefix
+ *
+ *   void rephase()
+ *       Resets the saved phases to the next phases of the schedule:
+ *       best, original, best, inverted, best, walk, best, random
+ *
+ *   void walkPhases()
+ *       Improves the saved phases by local search over the original clauses
+ *       and the assumptions
+ *
+ *   void bumpVariable(int variable)
+ *       Increases the activity of the given variable by the current
+ *       increment, rescaling all activities if they grow too large
+ *       @param variable The variable
+ *
+ *   void decayActivities()
+ *       Decays all activities at once by growing the increment
+ *
+ *   uint32_t abstractLevel(int variable)
+ *       Hashes the decision level of the given variable to one of 32 bits
+ *       @param variable The variable
+ *       @return A word with only the bit of the decision level set
+ *
+ *   bool literalRedundant(int literal, uint32_t abstract_levels)
+ *       Checks whether the given learned clause literal is implied by the
+ *       other literals, following reasons recursively; gives up as soon as
+ *       a decision or a level outside abstract_levels is met
+ *       @param literal The literal
+ *       @param abstract_levels The abstract levels of the learned clause
+ *       @return true if the literal can be removed
+ *
+ *   void minimizeLearnedClause()
+ *       Removes the redundant literals from the learned clause
+ *
+ *   void binaryMinimizeLearnedClause()
+ *       Removes the literals whose negation is implied by the negation of
+ *       the asserting literal through a binary clause
+ *
+ *   int computeLBD(int *literals, int size)
+ *       Counts the distinct decision levels of the given assigned literals
+ *       @param literals The literals
+ *       @param size The number of literals
+ *       @return The literal block distance
+ *
+ *   void bumpClause(ClauseRef clause_ref)
+ *       Increases the activity of the given learned clause, rescaling all
+ *       learned clause activities if they grow too large
+ *       @param clause_ref The reference of the clause
+ *
+ *   void updateLearnedClause(ClauseRef clause_ref)
+ *       Marks a learned clause taking part in a conflict as used, bumps it,
+ *       and moves it to a better tier if its LBD has dropped
+ *       @param clause_ref The reference of the clause
+ *
+ *   bool locked(ClauseRef clause_ref)
+ *       Checks whether the given clause is the reason of an assignment; any
+ *       literal of a ternary clause may be the one it implied
+ *       @param clause_ref The reference of the clause
+ *       @return true if the clause must not be deleted
+ *
+ *   void updateRestartAverages(int lbd)
+ *       Adds the LBD of a new learned clause and the trail size at its
+ *       conflict to the restart averages, postponing the next restart if
+ *       the trail is unusually long
+ *       @param lbd The LBD of the learned clause
+ *
+ *   bool restartDue()
+ *       Checks whether the restart policy asks for a restart
+ *       @return true if the solver should restart before the next decision
+ *
+ *   int reusedTrailLevel()
+ *       Finds the highest decision level whose decisions are all more
+ *       active than the variable that would be decided next
+ *       @return The decision level a restart can backtrack to
+ *
+ *   void restart()
+ *       Backtracks to decision level 0, or to the reusable part of the trail
+ *
+ *   void reduceDatabase()
+ *       Moves the tier2 clauses unused since the last reduction to the
+ *       local tier and deletes the worse half of the local clauses by LBD
+ *       and activity
+ *
+ *   int analyzeConflict(ClauseRef conflict_ref)
+ *       Derives the first UIP clause by resolving the conflict clause with
+ *       the reasons of its current decision level literals in reverse trail
+ *       order, learns it, backtracks and assigns its asserting literal
+ *       @param conflict_ref The reference of the conflicting clause
  *       @return The decision level to backtrack to
  *
- *   void backtrack(std::vector<int> &conflict_clause, int &decision_level)
- *       Backtracks to the given decision level
- *       @param conflict_clause The conflict clause
+ *   void backtrack(int decision_level)
+ *       Unassigns the literals above the given decision level by popping
+ *       them from the end of the trail
  *       @param decision_level The decision level to backtrack to
  *
+ *   void resizeVariables(int variable_count)
+ *       Makes sure the variables 1..variable_count exist, sizing the
+ *       per-variable arrays and the watch lists
+ *       @param variable_count The number of variables
+ *
+ *   void addClause(const int *literals, int size)
+ *       Normalizes a clause of the formula and stores it, creating its
+ *       variables if needed; between two solve() calls, the clause is also
+ *       simplified by the decision level 0 assignments, and the eliminated
+ *       and substituted variables it uses bring their clauses back
+ *       @param literals The literals of the clause
+ *       @param size The number of literals
+ *
+ *   void attachClauses()
+ *       Watches the clauses added since the last call, growing every watch
+ *       list once instead of once per watch
+ *
+ *   void detachClauses()
+ *       Moves every binary clause to the arena and empties the watch lists
+ *       and the ternary watch lists
+ *       so that clauses can be changed freely at decision level 0; clauses
+ *       satisfied at decision level 0 are freed and false literals removed
+ *
+ *   ClauseRef ownClause(ClauseRef clause_ref)
+ *       Replaces a detached base clause by a copy of its own, added to the
+ *       original clauses, so that its literals can be changed
+ *       @param clause_ref The reference of an original clause
+ *       @return The reference of the clause to change, clause_ref itself
+ *               if it is not in the base arena
+ *
+ *   void reattachClauses()
+ *       Moves the binary clauses of the arena back to the watch lists,
+ *       watches the other clauses again and drops the freed ones from the
+ *       clause lists
+ *
+ *   bool inprocess()
+ *       Backtracks to decision level 0 and simplifies the clauses by
+ *       substitution and subsumption
+ *       @return false if the formula has become unsatisfiable
+ *
+ *   void subsumeClauses()
+ *       Removes the clauses subsumed by another clause and strengthens the
+ *       clauses that resolve with another clause into a subset of
+ *       themselves; the clauses must be detached
+ *       A learned clause only removes learned clauses
+ *
+ *   bool subsumedBy(ClauseRef clause_ref, int marked_size, int &removed)
+ *       Checks whether the clause contains the marked literals, or all of
+ *       them but one that it contains negated
+ *       @param clause_ref The clause
+ *       @param marked_size The number of literals marked in literal_marks
+ *       @param removed Set to 0 if the clause is subsumed, otherwise to the
+ *                      literal of the clause that can be removed
+ *       @return true if the clause is subsumed or can be strengthened
+ *
+ *   void substituteEquivalentLiterals()
+ *       Finds the strongly connected components of the binary implication
+ *       graph with Tarjan's algorithm and replaces the literals of each by
+ *       the one with the smallest variable in every clause; the replaced
+ *       variables go to the extension stack as two binary clauses, and a
+ *       component with a literal and its negation makes the formula
+ *       unsatisfiable; the clauses must be detached
+ *
+ *   bool probeLiterals()
+ *       Backtracks to decision level 0 and probes the variables with a
+ *       literal that is a root of the binary implication graph, both values
+ *       of each: a failed literal makes its negation a unit, and the literals
+ *       implied by both values become units too
+ *       Probing starts where the previous round stopped and gives up once
+ *       its share of the search propagations is spent
+ *       @return false if the formula has become unsatisfiable
+ *
+ *   bool probeLiteral(int literal)
+ *       Assigns a literal at decision level 1 and propagates it; every
+ *       literal it implies through a longer clause is then implied directly
+ *       by a learned hyper binary resolvent
+ *       @param literal The literal
+ *       @return false if the propagation is conflicting
+ *
+ *   bool vivifyClauses()
+ *       Backtracks to decision level 0 and, for each clause not vivified
+ *       yet, falsifies its literals one by one, each at a new decision
+ *       level: the literals falsified by the others are dropped, and the
+ *       ones after a conflict or a true literal too; a learned clause
+ *       implied by the other clauses is removed
+ *       Tier2 clauses go first, those used since the last reduction before
+ *       the others, then original clauses; the clauses of each class are
+ *       sorted so that consecutive clauses share their first decisions, and
+ *       the round gives up once its share of the search propagations is spent
+ *       @return false if the formula has become unsatisfiable
+ *
+ *   long long searchPropagations()
+ *       Counts the propagations made by the search itself
+ *       @return The propagations minus those of probing, vivification and
+ *               lookahead
+ *
+ *   bool sharedBefore(const int *literals, int size)
+ *       Records a clause sent or received through the exchange in a table
+ *       of hashes, where newer clauses overwrite older ones
+ *       @param literals The literals of the clause, in any order
+ *       @param size The number of literals
+ *       @return true if the table already held the clause
+ *
+ *   void exportClause(const int *literals, int size, int lbd)
+ *       Sends a learned clause to the other solvers if it is short enough,
+ *       its LBD is within the current limit and it was not sent or
+ *       received before; the limit is adjusted to the traffic every
+ *       share_interval conflicts
+ *       @param literals The literals of the clause
+ *       @param size The number of literals
+ *       @param lbd The literal block distance of the clause
+ *
+ *   bool importClauses()
+ *       Backtracks to decision level 0 and adds the clauses sent by the
+ *       other solvers as learned clauses, skipping those received before,
+ *       those satisfied at decision level 0 and those with an eliminated or
+ *       substituted variable
+ *       @return false if the formula has become unsatisfiable
+ *
+ *   void eliminateVariables()
+ *       Runs bounded variable elimination on the original clauses before
+ *       they are watched: a variable is replaced by the resolvents of its
+ *       clauses when there are no more of them than clauses removed; the
+ *       removed clauses go to the extension stack; the clauses must be
+ *       detached
+ *
+ *   bool propagateOccurrences(int &head)
+ *       Assigns the units found during elimination at decision level 0,
+ *       freeing the satisfied clauses and removing the false literals
+ *       @param head The position in the trail of the next unit, updated
+ *       @return false if the formula has become unsatisfiable
+ *
+ *   void cleanOccurrences(int literal)
+ *       Drops the freed clauses from the occurrence list of a literal
+ *       @param literal The literal
+ *
+ *   bool resolve(ClauseRef positive_ref, ClauseRef negative_ref, int variable)
+ *       Resolves two clauses on a variable, appending the resolvent and a
+ *       0 to resolvents
+ *       @param positive_ref The clause with the positive literal
+ *       @param negative_ref The clause with the negative literal
+ *       @param variable The variable
+ *       @return false if the resolvent is a tautology
+ *
+ *   bool eliminateVariable(int variable, long long &effort)
+ *       Eliminates a variable if its resolvents are few and short enough
+ *       @param variable The variable
+ *       @param effort The literals visited so far, updated
+ *       @return false if the formula has become unsatisfiable
+ *
+ *   bool prepareSearch()
+ *       Simplifies the formula before the first search, watches the
+ *       clauses added since the last call and propagates the units at
+ *       decision level 0
+ *       @return false if the formula is unsatisfied
+ *
+ *   SAT search()
+ *       Runs the CDCL search from decision level 0, deciding the
+ *       assumptions first
+ *       @return satisfied, unsatisfied (see failed_assumption), or normal
+ *               if the terminate flag was set or the conflict limit was
+ *               reached first
+ *
  *   bool solve()
- *       Solves the formula
+ *       Solves the formula under the assumptions given by assume() since
+ *       the last call, keeping the learned clauses, the activities and the
+ *       phases of the previous calls
  *       @return true if the formula is satisfied
- *               false if the formula is unsatisfied
+ *               false if the formula or the assumptions are unsatisfiable,
+ *               or the search was terminated (see getResult)
+ *
+ *   SAT solveAssuming(const std::vector<int> &assumptions, long long conflict_budget)
+ *       Solves the formula under assumptions, keeping the learned clauses
+ *       of the previous calls; the variables assumed must not be
+ *       eliminated or substituted
+ *       @param assumptions The literals assumed true
+ *       @param conflict_budget The conflicts allowed, negative for no limit
+ *       @return satisfied, unsatisfied if the formula or the assumptions
+ *               are unsatisfiable, or normal if the search gave up
+ *
+ *   void assume(int literal)
+ *       Assumes a literal true for the next solve() only
+ *       @param literal The literal
+ *
+ *   int value(int literal)
+ *       Gets the value of a literal in the model of the last satisfied
+ *       search
+ *       @param literal The literal
+ *       @return literal if it is true, -literal if it is false, 0 if the
+ *               variable is unknown
+ *
+ *   bool failed(int literal)
+ *       Checks whether an assumption of the last unsatisfied search takes
+ *       part in its refutation
+ *       @param literal The assumption
+ *       @return true if the assumption failed
+ *
+ *   void freeze(int variable), melt(int variable)
+ *       Keeps a variable from being eliminated or substituted, or undoes
+ *       one freeze; clauses and assumptions may use a variable that is not
+ *       frozen, but then every removed clause is added back
+ *       @param variable The variable
+ *
+ *   void setTerminateCallback(int (*callback)(void *), void *data)
+ *       Makes solve() give up at its next decision once the callback
+ *       returns a nonzero value
+ *       @param callback The callback, or nullptr to never give up
+ *       @param data The argument of the callback
+ *
+ *   void setLearnCallback(void (*callback)(void *, int *), void *data, int max_size)
+ *       Passes every learned clause short enough to a callback, as a
+ *       zero-terminated array of literals
+ *       @param callback The callback, or nullptr for none
+ *       @param data The first argument of the callback
+ *       @param max_size The largest clause passed
+ *
+ *   void analyzeFinal()
+ *       Collects the assumptions that imply the negation of the failed
+ *       assumption, which fail with it
+ *
+ *   void restoreEliminated()
+ *       Backtracks to decision level 0 and adds every clause of the
+ *       extension stack back as an original clause, so that no variable is
+ *       eliminated or substituted anymore
+ *
+ *   void extendModel()
+ *       Copies the assignment to the model, giving the eliminated and
+ *       substituted variables values that satisfy their removed clauses
+ *
+ *   SAT lookahead(std::vector<int> &cube, int &split_literal)
+ *       Assumes a cube and propagates both literals of the most promising
+ *       free variables, choosing the one whose literals assign the most on
+ *       both sides to split the cube; a literal whose propagation fails
+ *       adds its negation to the cube
+ *       @param cube The literals assumed true, extended
+ *       @param split_literal The variable chosen, with the phase the search
+ *                            would give it, 0 if there is none
+ *       @return unsatisfied if the cube is refuted, normal otherwise
+ *
+ *   SAT getResult()
+ *       Gets the outcome of the last solve()
+ *       @return satisfied, unsatisfied, or normal if the search was
+ *               terminated or has not run
+ *
+ *   void setTerminateFlag(const std::atomic<bool> *terminate_flag)
+ *       Makes solve() give up at its next decision once the flag is set
+ *       @param terminate_flag The flag, or nullptr to never give up
+ *
+ *   void setClauseExchange(ClauseExchange *exchange, int worker)
+ *       Makes solve() export its short learned clauses to an exchange and
+ *       import those of the other solvers at restarts and whenever it is
+ *       back at decision level 0
+ *       @param exchange The exchange, or nullptr to share nothing
+ *       @param worker The index of the solver in the exchange
+ *
+ *   void moveClausesToBase()
+ *       Moves the original clauses to a base arena that is never written
+ *       again, so that other solvers can read them through
+ *       shareBaseClauses; the binary clauses stay with the solver, as they
+ *       only live in the watch lists. It must be called before the first
+ *       search, and does nothing once the clauses are in a base arena
+ *
+ *   void shareBaseClauses(SATSolver &formula)
+ *       Gives a solver without clauses those of another solver that has
+ *       moved them to a base arena and has not solved yet; the base
+ *       clauses are read in place rather than copied, and the other solver
+ *       is only read, so several solvers can share it at the same time
+ *       @param formula The solver holding the formula
+ *
+ *   std::vector<std::pair<int, bool>> getAssignment()
+ *       Gets the model found by the last satisfied search
+ *       @return The value of every variable, sorted by variable
  *
  * Data members:
- *   std::vector<Literal> literals
- *      The literals
- *          Literal:
- *              int literal
- *                  The literal
- *              int value
- *                  The value of the literal
- *                  1: true, 0: false, -1: unassigned
- *              int decision_level
- *                  The decision level of the literal
- *              int antecedent_clause
- *                  The antecedent clause of the literal
- *              double score
- *                  The score of the literal
- *
- *   std::vector<std::vector<int>> formula
- *       The formula
- *
- *   int literal_count
- *       The number of literals
- *
- *   int assigned_literal_count
- *       The number of assigned literals
- *
- *   int antecedent_clause
- *       The antecedent clause
+ *   std::vector<signed char> values
+ *       The value of each variable, indexed by variable
+ *       1: true, 0: false, -1: unassigned
+ *
+ *   std::vector<int> levels
+ *       The decision level of each assigned variable, indexed by variable
+ *
+ *   std::vector<ClauseRef> reasons
+ *       The antecedent clause of each assigned variable, indexed by variable
+ *       CLAUSE_UNDEF for decisions
+ *
+ *   std::vector<double> activity
+ *       The VSIDS score of each variable, indexed by variable
+ *
+ *   std::vector<char> seen
+ *       Marks the variables met during conflict analysis, indexed by variable
+ *       Cleared again before analyzeConflict returns
+ *
+ *   std::vector<int> learned_clause
+ *       The clause being learned, reused across conflicts
+ *       The asserting literal is first and the literal with the highest
+ *       remaining decision level is second
+ *
+ *   std::vector<int> analyze_stack
+ *       The literals still to be visited by literalRedundant
+ *
+ *   std::vector<int> analyze_toclear
+ *       The literals whose seen marks must be cleared after minimization
+ *
+ *   std::vector<int> added_clause
+ *       The clause being normalized by addClause
+ *
+ *   std::vector<int> pending_binaries
+ *       The literals of the binary clauses added but not watched yet,
+ *       two by two
+ *
+ *   int attached_clause_count
+ *       The number of original clauses already watched
+ *
+ *   std::vector<std::vector<ClauseRef>> occurrences
+ *       The clauses containing each literal during elimination, indexed
+ *       by watchIndex(literal); empty otherwise
+ *
+ *   std::vector<char> literal_marks
+ *       Marks the literals of a clause, indexed by watchIndex(literal)
+ *       Cleared again after every use
+ *
+ *   std::vector<int> resolvents
+ *       The resolvents of the variable being eliminated, each followed
+ *       by a 0
+ *
+ *   std::vector<char> eliminated
+ *       Whether each variable has been eliminated or substituted, indexed
+ *       by variable
+ *
+ *   int eliminated_count
+ *       The number of eliminated and substituted variables
+ *
+ *   std::vector<int> frozen
+ *       The number of times each variable was frozen, indexed by variable
+ *
+ *   std::vector<int> extension_stack
+ *       The clauses removed by elimination and substitution, in order; each clause has the
+ *       literal to make true if it is falsified first and is followed by
+ *       its size
+ *
+ *   VariableHeap order_heap
+ *       The variables ordered by activity
+ *       Every unassigned variable is in the heap
+ *
+ *   double activity_increment
+ *       The amount added to the activity of a bumped variable
+ *
+ *   double activity_decay
+ *       The decay factor of the activities; the increment is divided by it
+ *       after every conflict, which decays every activity in O(1)
+ *
+ *   ClauseArena arena
+ *       The storage of every original and learned clause
+ *
+ *   std::vector<ClauseRef> clauses
+ *       The original clauses
+ *
+ *   std::vector<ClauseRef> learnts[3]
+ *       The learned clauses of each tier, indexed by ClauseTier
+ *       A clause moved to another tier leaves a stale entry in its old
+ *       list, dropped at the next reduction
+ *
+ *   double clause_activity_increment
+ *       The amount added to the activity of a bumped learned clause
+ *
+ *   long long next_reduce
+ *       The number of conflicts at which the next reduction happens
+ *
+ *   std::vector<int> level_stamps
+ *       The last LBD computation that met each decision level
+ *
+ *   int lbd_stamp
+ *       The stamp of the current LBD computation
+ *
+ *   std::vector<signed char> saved_phases
+ *       The last value of each variable, indexed by variable
+ *
+ *   std::vector<signed char> target_phases, best_phases
+ *       The values of each variable on the longest conflict-free trail since
+ *       the last rephase and since best phases were last used
+ *       -1 if the variable was not on that trail
+ *
+ *   int target_trail_size, best_trail_size
+ *       The sizes of those trails
+ *
+ *   long long next_rephase
+ *       The number of conflicts at which the next rephase happens
+ *
+ *   long long next_subsumption
+ *       The number of conflicts at which the next inprocessing round happens
+ *
+ *   long long next_probe
+ *       The number of conflicts at which the next probing round happens
+ *
+ *   int probe_variable
+ *       The variable the next probing round starts from
+ *
+ *   long long probed_search_propagations
+ *       The number of search propagations at the last probing round
+ *
+ *   long long next_vivify
+ *       The number of conflicts at which the next vivification round happens
+ *
+ *   long long vivified_search_propagations
+ *       The number of search propagations at the last vivification round
+ *
+ *   std::mt19937 random_generator
+ *       The source of randomness
+ *
+ *   ExponentialMovingAverage lbd_fast_average, lbd_slow_average
+ *       The recent and the long-term average LBD of learned clauses
+ *
+ *   ExponentialMovingAverage trail_average
+ *       The average trail size at conflicts
+ *
+ *   long long conflicts_since_restart
+ *       The number of conflicts since the last restart
+ *
+ *   bool empty_clause_found
+ *       Whether the formula has an empty clause
+ *
+ *   int simplified_trail_size
+ *       The number of decision level 0 assignments when the satisfied
+ *       clauses were last removed
+ *
+ *   int variable_count
+ *       The number of variables
+ *
+ *   std::vector<std::vector<Watcher>> watches
+ *       The watch lists, indexed by watchIndex(literal)
+ *       Each list holds the watchers of the clauses in which the literal
+ *       is one of the first two (watched) literals
+ *
+ *   std::vector<std::vector<TernaryWatcher>> ternary_watches
+ *       The ternary watch lists, indexed by watchIndex(literal)
+ *       Each list holds the watchers of the ternary clauses with the literal
+ *
+ *   int binary_conflict[2]
+ *       The literals of the last binary clause found conflicting
+ *
+ *   int binary_reason[2]
+ *       The literals of the binary reason returned by reasonLiterals
+ *
+ *   std::vector<int> base_reason
+ *       The literals of the last base clause returned by reasonLiterals
+ *
+ *   std::vector<int> trail
+ *       The assigned literals in assignment order
+ *
+ *   std::vector<int> trail_lim
+ *       The position in the trail where each decision level starts
+ *
+ *   int propagation_head
+ *       The position in the trail of the next literal to propagate
  *
  *   int strategy
  *       The strategy
  *       0: basic strategy
  *       1: VSIDS
+ *
+ *   SATSolverOptions options
+ *       The tunable parameters
+ *
+ *   SATSolverStatistics statistics
+ *       The counters collected while solving
+ *
+ *   SAT result
+ *       The outcome of the last solve(), normal before it
+ *
+ *   const std::atomic<bool> *terminate_flag
+ *       The flag that makes solve() give up, nullptr if there is none
+ *
+ *   bool prepared
+ *       Whether the formula was simplified and the search schedules set
+ *
+ *   std::vector<int> assumptions
+ *       The literals assumed true by the current search
+ *
+ *   long long conflict_limit
+ *       The number of conflicts at which the current search gives up
+ *
+ *   int failed_assumption
+ *       The assumption found false by the last search, 0 if there is none
+ *
+ *   std::vector<int> pending_assumptions
+ *       The assumptions of the next solve()
+ *
+ *   std::vector<int> failed_core
+ *       The failed assumptions of the last search, sorted
+ *
+ *   std::vector<signed char> model
+ *       The values of the variables in the model of the last satisfied
+ *       search, indexed by variable
+ *
+ *   int (*terminate_callback)(void *), void *terminate_data
+ *       The callback that makes solve() give up and its argument
+ *
+ *   void (*learn_callback)(void *, int *), void *learn_data
+ *       The callback receiving the learned clauses and its first argument
+ *
+ *   int learn_max_size
+ *       The largest learned clause passed to the callback
+ *
+ *   ClauseExchange *exchange
+ *       The exchange shared with the other solvers, nullptr if there is none
+ *
+ *   int exchange_worker
+ *       The index of the solver in the exchange
+ *
+ *   int share_lbd
+ *       The current LBD limit of exported clauses
+ *
+ *   long long next_share_update
+ *       The number of conflicts at which the LBD limit is next adjusted
+ *
+ *   long long shared_exports
+ *       The number of exported clauses at the last adjustment
+ *
+ *   std::vector<uint64_t> shared_hashes
+ *       The hashes of recently sent and received clauses, indexed by their
+ *       low bits; 0 for none
+ *
+ *   std::vector<int> shared_clauses
+ *       The clauses collected from the exchange, reused across imports
  */
 
 class SATSolver
 {
 private:
     // Member functions
-    int get_literal_index(int &);
-    int unitPropagation(int &);
+    int watchIndex(int);
+    int literalValue(int);
+    int decisionLevel();
+    void newDecisionLevel();
+    void assignLiteral(int, ClauseRef);
+    void watchClause(ClauseRef);
+    void watchBinaryClause(int, int, bool);
+    void attachClauses();
+    void detachClauses();
+    ClauseRef ownClause(ClauseRef);
+    void reattachClauses();
+    bool inprocess();
+    void subsumeClauses();
+    bool subsumedBy(ClauseRef, int, int &);
+    void substituteEquivalentLiterals();
+    bool probeLiterals();
+    bool probeLiteral(int);
+    bool vivifyClauses();
+    long long searchPropagations();
+    bool sharedBefore(const int *, int);
+    void exportClause(const int *, int, int);
+    bool importClauses();
+    void eliminateVariables();
+    bool propagateOccurrences(int &);
+    void cleanOccurrences(int);
+    bool resolve(ClauseRef, ClauseRef, int);
+    bool eliminateVariable(int, long long &);
+    int *reasonLiterals(ClauseRef, int, int &);
+    void initialize(std::vector<std::vector<int>> &, int);
+    void removeSatisfied(std::vector<ClauseRef> &);
+    void purgeWatches();
+    void simplifyDatabase();
+    void garbageCollect();
+    ClauseRef unitPropagation();
     int chooseLiteral();
-    int analyzeConflict(int);
-    void backtrack(std::vector<int> &, int &);
+    void updateTargetPhases(int);
+    void rephase();
+    void walkPhases();
+    void bumpVariable(int);
+    void decayActivities();
+    uint32_t abstractLevel(int);
+    bool literalRedundant(int, uint32_t);
+    void minimizeLearnedClause();
+    void binaryMinimizeLearnedClause();
+    int computeLBD(int *, int);
+    void bumpClause(ClauseRef);
+    void updateLearnedClause(ClauseRef);
+    bool locked(ClauseRef);
+    void updateRestartAverages(int);
+    bool restartDue();
+    int reusedTrailLevel();
+    void restart();
+    void reduceDatabase();
+    int analyzeConflict(ClauseRef);
+    void backtrack(int);
     void printFormula(std::vector<std::vector<int>> &);
+    bool prepareSearch();
+    SAT search();
+    void analyzeFinal();
+    void restoreEliminated();
+    void extendModel();
 
     // Data members
-    struct Literal
-    {
-        int literal; // absolute value of literal
-        int value; // 1: true, 0: false, -1: unassigned
-        int decision_level;
-        int antecedent_clause;
-        double score;
-        Literal(int literal, int value, int decision_level, int antecedent_clause = -1)
-        {
-            this->literal = literal;
-            this->value = value;
-            this->decision_level = decision_level;
-            this->antecedent_clause = -1;
-            this->score = 0;
-        }
-    };
-
-    std::vector<Literal> literals;
-    std::vector<std::vector<int>> formula;
-    int literal_count;
-    int assigned_literal_count;
-    int antecedent_clause;
-    int strategy; // 0: basic strategy, 1: VSIDS
+    std::vector<signed char> values; // 1: true, 0: false, -1: unassigned
+    std::vector<int> levels;
+    std::vector<ClauseRef> reasons;
+    std::vector<double> activity;
+    std::vector<char> seen;
+    std::vector<int> learned_clause;
+    std::vector<int> analyze_stack;
+    std::vector<int> analyze_toclear;
+    std::vector<int> added_clause;
+    std::vector<int> pending_binaries;
+    int attached_clause_count;
+    std::vector<std::vector<ClauseRef>> occurrences;
+    std::vector<char> literal_marks;
+    std::vector<int> resolvents;
+    std::vector<char> eliminated;
+    int eliminated_count;
+    std::vector<int> frozen;
+    std::vector<int> extension_stack;
+    VariableHeap order_heap;
+    double activity_increment;
+    double activity_decay;
+    ClauseArena arena;
+    std::vector<ClauseRef> clauses;
+    std::vector<ClauseRef> learnts[3];
+    double clause_activity_increment;
+    long long next_reduce;
+    std::vector<int> level_stamps;
+    int lbd_stamp;
+    std::vector<signed char> saved_phases;
+    std::vector<signed char> target_phases;
+    std::vector<signed char> best_phases;
+    int target_trail_size;
+    int best_trail_size;
+    long long next_rephase;
+    long long next_subsumption;
+    long long next_probe;
+    int probe_variable;
+    long long probed_search_propagations;
+    long long next_vivify;
+    long long vivified_search_propagations;
+    std::mt19937 random_generator;
+    ExponentialMovingAverage lbd_fast_average;
+    ExponentialMovingAverage lbd_slow_average;
+    ExponentialMovingAverage trail_average;
+    long long conflicts_since_restart;
+    bool empty_clause_found;
+    int simplified_trail_size;
+    int variable_count;
+    std::vector<std::vector<Watcher>> watches;
+    std::vector<std::vector<TernaryWatcher>> ternary_watches;
+    int binary_conflict[2];
+    int binary_reason[2];
+    std::vector<int> base_reason;
+    std::vector<int> trail;
+    std::vector<int> trail_lim;
+    int propagation_head;
+    int strategy; // 0: basic strategy, 1: VSIDS
+    SATSolverOptions options;
+    SATSolverStatistics statistics;
+    SAT result;
+    const std::atomic<bool> *terminate_flag;
+    bool prepared;
+    std::vector<int> assumptions;
+    long long conflict_limit;
+    int failed_assumption;
+    std::vector<int> pending_assumptions;
+    std::vector<int> failed_core;
+    std::vector<signed char> model;
+    int (*terminate_callback)(void *);
+    void *terminate_data;
+    void (*learn_callback)(void *, int *);
+    void *learn_data;
+    int learn_max_size;
+    ClauseExchange *exchange;
+    int exchange_worker;
+    int share_lbd;
+    long long next_share_update;
+    long long shared_exports;
+    std::vector<uint64_t> shared_hashes;
+    std::vector<int> shared_clauses;
 
 public:
     // Constructors
     SATSolver(std::vector<std::vector<int>> &);
     SATSolver(std::vector<std::vector<int>> &, int &);
+    SATSolver(std::vector<std::vector<int>> &, int &, int &);
+    SATSolver(std::vector<std::vector<int>> &, int &, SATSolverOptions &);
+    SATSolver(SATSolverOptions &);
 
     // Member functions
+    void resizeVariables(int);
+    void addClause(const int *, int);
     bool solve();
+    SAT solveAssuming(const std::vector<int> &, long long);
+    SAT lookahead(std::vector<int> &, int &);
+    void assume(int);
+    int value(int);
+    bool failed(int);
+    void freeze(int);
+    void melt(int);
+    void setTerminateCallback(int (*)(void *), void *);
+    void setLearnCallback(void (*)(void *, int *), void *, int);
+    SAT getResult();
+    void setTerminateFlag(const std::atomic<bool> *);
+    void setClauseExchange(ClauseExchange *, int);
+    void moveClausesToBase();
+    void shareBaseClauses(SATSolver &);
     std::vector<std::pair<int, bool>> getAssignment();
+    SATSolverStatistics getStatistics();
+    void printStatistics(std::ostream &);
 };
 
-SATSolver::SATSolver(std::vector<std::vector<int>> &formula)
+SATSolver::SATSolver(std::vector<std::vector<int>> &formula) : order_heap(activity)
+{
+    // Without a problem line, the largest variable is the number of variables
+    int variable_count = 0;
+    for (auto &clause : formula)
+    {
+        for (int literal : clause)
+        {
+            variable_count = std::max(variable_count, abs(literal));
+        }
+    }
+
+    // Initialize the variables, the clauses, the watch lists and the trail
+    SATSolver::initialize(formula, variable_count);
+
+    // Initialize the strategy
+    this->strategy = 1;
+}
+
+SATSolver::SATSolver(std::vector<std::vector<int>> &formula, int &strategy) : order_heap(activity)
+{
+    // Without a problem line, the largest variable is the number of variables
+    int variable_count = 0;
+    for (auto &clause : formula)
+    {
+        for (int literal : clause)
+        {
+            variable_count = std::max(variable_count, abs(literal));
+        }
+    }
+
+    // Initialize the variables, the clauses, the watch lists and the trail
+    SATSolver::initialize(formula, variable_count);
+
+    // Initialize the strategy
+    this->strategy = strategy;
+}
+
+SATSolver::SATSolver(std::vector<std::vector<int>> &formula, int &variable_count, int &strategy) : order_heap(activity)
+{
+    // Initialize the variables, the clauses, the watch lists and the trail
+    SATSolver::initialize(formula, variable_count);
+
+    // Initialize the strategy
+    this->strategy = strategy;
+}
+
+SATSolver::SATSolver(std::vector<std::vector<int>> &formula, int &variable_count, SATSolverOptions &options) : order_heap(activity)
+{
+    // Initialize the variables, the clauses, the watch lists and the trail
+    SATSolver::initialize(formula, variable_count);
+
+    // Initialize the options and the strategy
+    this->options = options;
+    this->strategy = options.strategy;
+}
+
+SATSolver::SATSolver(SATSolverOptions &options) : order_heap(activity)
+{
+    // Start without variables or clauses; they are added by addClause
+    std::vector<std::vector<int>> formula;
+    SATSolver::initialize(formula, 0);
+
+    // Initialize the options and the strategy
+    this->options = options;
+    this->strategy = options.strategy;
+}
+
+int SATSolver::watchIndex(int literal)
+{
+    return literal > 0 ? 2 * literal : 2 * (-literal) + 1;
+}
+
+int SATSolver::literalValue(int literal)
+{
+    int value = values[abs(literal)];
+
+    // If the literal is unassigned, so is its value
+    if (value == -1)
+    {
+        return -1;
+    }
+
+    return literal > 0 ? value : 1 - value;
+}
+
+int SATSolver::decisionLevel()
+{
+    return trail_lim.size();
+}
+
+void SATSolver::newDecisionLevel()
+{
+    trail_lim.push_back(trail.size());
+}
+
+void SATSolver::assignLiteral(int literal, ClauseRef antecedent_clause)
+{
+    int variable = abs(literal);
+    values[variable] = literal > 0 ? 1 : 0;
+    levels[variable] = SATSolver::decisionLevel();
+    reasons[variable] = antecedent_clause;
+
+    trail.push_back(literal);
+}
+
+void SATSolver::watchClause(ClauseRef clause_ref)
+{
+    Clause &clause = arena[clause_ref];
+    if (clause.size() == 3)
+    {
+        ternary_watches[SATSolver::watchIndex(clause[0])].push_back({clause[1], clause[2], clause_ref});
+        ternary_watches[SATSolver::watchIndex(clause[1])].push_back({clause[0], clause[2], clause_ref});
+        ternary_watches[SATSolver::watchIndex(clause[2])].push_back({clause[0], clause[1], clause_ref});
+        return;
+    }
+
+    if (arena.inBase(clause_ref))
+    {
+        BaseClauseState &state = arena.baseState(clause_ref);
+        state.first_watch = 0;
+        state.second_watch = 1;
+    }
+    watches[SATSolver::watchIndex(clause[0])].push_back({clause[1], clause_ref});
+    watches[SATSolver::watchIndex(clause[1])].push_back({clause[0], clause_ref});
+}
+
+void SATSolver::watchBinaryClause(int first, int second, bool learnt)
+{
+    ClauseRef binary_ref = learnt ? BINARY_LEARNT : BINARY_ORIGINAL;
+    watches[SATSolver::watchIndex(first)].push_back({second, binary_ref});
+    watches[SATSolver::watchIndex(second)].push_back({first, binary_ref});
+}
+
+int *SATSolver::reasonLiterals(ClauseRef reason_ref, int implied_literal, int &size)
+{
+    if (!isBinaryReason(reason_ref))
+    {
+        // Ternary clauses are not reordered when they propagate, so the
+        // implied literal is moved first only once it is needed
+        Clause &clause = arena[reason_ref];
+        size = clause.size();
+
+        // Base clauses are only read, so the reordering happens on a copy
+        if (arena.inBase(reason_ref) && implied_literal != 0 && clause[0] != implied_literal)
+        {
+            base_reason.assign(clause.literals(), clause.literals() + size);
+            std::swap(base_reason[0], *std::find(base_reason.begin(), base_reason.end(), implied_literal));
+            return base_reason.data();
+        }
+        if (size == 3 && implied_literal != 0 && clause[0] != implied_literal)
+        {
+            std::swap(clause[0], clause[clause[1] == implied_literal ? 1 : 2]);
+        }
+        return clause.literals();
+    }
+
+    size = 2;
+    if (implied_literal == 0)
+    {
+        return binary_conflict;
+    }
+
+    binary_reason[0] = implied_literal;
+    binary_reason[1] = binaryReasonLiteral(reason_ref);
+    return binary_reason;
+}
+
+void SATSolver::initialize(std::vector<std::vector<int>> &formula, int variable_count)
+{
+    this->variable_count = 0;
+    prepared = false;
+    lbd_stamp = 0;
+    clause_activity_increment = 1.0;
+    activity_increment = 1.0;
+    activity_decay = 0.95;
+    SATSolver::resizeVariables(variable_count);
+
+    // Reserve room for every header and literal up front
+    size_t arena_words = 0;
+    for (auto &clause : formula)
+    {
+        arena_words += CLAUSE_HEADER_WORDS + clause.size();
+    }
+    arena.reserve(arena_words);
+    empty_clause_found = false;
+    attached_clause_count = 0;
+    eliminated_count = 0;
+    result = normal;
+    terminate_flag = nullptr;
+    conflict_limit = LLONG_MAX;
+    failed_assumption = 0;
+    terminate_callback = nullptr;
+    terminate_data = nullptr;
+    learn_callback = nullptr;
+    learn_data = nullptr;
+    learn_max_size = 0;
+    exchange = nullptr;
+    exchange_worker = 0;
+
+    for (auto &clause : formula)
+    {
+        SATSolver::addClause(clause.data(), clause.size());
+    }
+
+    trail.clear();
+    trail_lim.clear();
+    propagation_head = 0;
+    simplified_trail_size = 0;
+}
+
+void SATSolver::resizeVariables(int variable_count)
+{
+    if (variable_count <= this->variable_count)
+    {
+        return;
+    }
+
+    // Variables are numbered from 1, so every array has an unused entry 0
+    int first_new = this->variable_count + 1;
+    this->variable_count = variable_count;
+    values.resize(variable_count + 1, -1);
+    levels.resize(variable_count + 1, -1);
+    reasons.resize(variable_count + 1, CLAUSE_UNDEF);
+    activity.resize(variable_count + 1, 0.0);
+    seen.resize(variable_count + 1, 0);
+    level_stamps.resize(variable_count + 1, 0);
+    eliminated.resize(variable_count + 1, 0);
+    frozen.resize(variable_count + 1, 0);
+    watches.resize(2 * variable_count + 2);
+    ternary_watches.resize(2 * variable_count + 2);
+    literal_marks.resize(2 * variable_count + 2, 0);
+
+    // Variables added between searches need phases too
+    if (prepared)
+    {
+        saved_phases.resize(variable_count + 1, options.initial_phase);
+        target_phases.resize(variable_count + 1, -1);
+        best_phases.resize(variable_count + 1, -1);
+    }
+
+    // Every new variable is unassigned, so it goes into the heap
+    order_heap.resize(variable_count);
+    for (int variable = first_new; variable <= variable_count; variable++)
+    {
+        order_heap.insert(variable);
+    }
+}
+
+void SATSolver::addClause(const int *literals, int size)
+{
+    // Between searches, the removed variables of the clause come back first
+    if (prepared)
+    {
+        SATSolver::backtrack(0);
+        for (int i = 0; i < size; i++)
+        {
+            if (abs(literals[i]) <= variable_count && eliminated[abs(literals[i])])
+            {
+                SATSolver::restoreEliminated();
+                break;
+            }
+        }
+    }
+
+    // Remove duplicate literals and tautologies so that the two watched
+    // literals of every clause are distinct
+    added_clause.assign(literals, literals + size);
+    std::sort(added_clause.begin(), added_clause.end(), [](int a, int b)
+              { return abs(a) < abs(b) || (abs(a) == abs(b) && a < b); });
+    added_clause.erase(std::unique(added_clause.begin(), added_clause.end()), added_clause.end());
+
+    // The empty clause is not stored, it makes the formula unsatisfiable
+    if (added_clause.empty())
+    {
+        empty_clause_found = true;
+        return;
+    }
+
+    // The literals are sorted by variable, so the last one is the largest;
+    // the variables of a tautology still get a value in the model
+    SATSolver::resizeVariables(abs(added_clause.back()));
+
+    for (int i = 1; i < added_clause.size(); i++)
+    {
+        if (added_clause[i] == -added_clause[i - 1])
+        {
+            return;
+        }
+    }
+
+    // Between searches, a clause satisfied at decision level 0 is dropped,
+    // and so are its false literals, so that it can be watched directly
+    if (prepared)
+    {
+        int kept = 0;
+        for (int literal : added_clause)
+        {
+            int value = SATSolver::literalValue(literal);
+            if (value == 1)
+            {
+                return;
+            }
+            else if (value == -1)
+            {
+                added_clause[kept++] = literal;
+            }
+        }
+        added_clause.resize(kept);
+
+        if (added_clause.empty())
+        {
+            empty_clause_found = true;
+            return;
+        }
+    }
+
+    // Binary clauses will live in the watch lists only; every clause is
+    // watched by attachClauses once all of them are known
+    if (added_clause.size() == 2)
+    {
+        pending_binaries.push_back(added_clause[0]);
+        pending_binaries.push_back(added_clause[1]);
+        return;
+    }
+
+    ClauseRef clause_ref = arena.allocate(added_clause.data(), added_clause.size(), false);
+    clauses.push_back(clause_ref);
+}
+
+void SATSolver::attachClauses()
+{
+    // Count the new watches of every literal first, so that each watch
+    // list grows at most once
+    std::vector<int> new_watches(watches.size(), 0);
+    for (int i = attached_clause_count; i < clauses.size(); i++)
+    {
+        Clause &clause = arena[clauses[i]];
+        if (clause.size() >= 2 && clause.size() != 3)
+        {
+            new_watches[SATSolver::watchIndex(clause[0])]++;
+            new_watches[SATSolver::watchIndex(clause[1])]++;
+        }
+    }
+    for (int literal : pending_binaries)
+    {
+        new_watches[SATSolver::watchIndex(literal)]++;
+    }
+
+    for (int i = 0; i < watches.size(); i++)
+    {
+        if (new_watches[i] > 0)
+        {
+            watches[i].reserve(watches[i].size() + new_watches[i]);
+        }
+    }
+
+    for (int i = attached_clause_count; i < clauses.size(); i++)
+    {
+        if (arena[clauses[i]].size() >= 2)
+        {
+            SATSolver::watchClause(clauses[i]);
+        }
+    }
+    for (int i = 0; i < pending_binaries.size(); i += 2)
+    {
+        SATSolver::watchBinaryClause(pending_binaries[i], pending_binaries[i + 1], false);
+    }
+
+    attached_clause_count = clauses.size();
+    pending_binaries.clear();
+    pending_binaries.shrink_to_fit();
+}
+
+void SATSolver::detachClauses()
+{
+    // Binary clauses waiting to be watched are original clauses
+    for (int i = 0; i < pending_binaries.size(); i += 2)
+    {
+        clauses.push_back(arena.allocate(&pending_binaries[i], 2, false));
+    }
+    pending_binaries.clear();
+
+    // Take every watched binary clause once, from the watch list of its
+    // smaller literal, then forget every watch
+    for (int literal = -variable_count; literal <= variable_count; literal++)
+    {
+        if (literal == 0)
+        {
+            continue;
+        }
+
+        for (Watcher watcher : watches[SATSolver::watchIndex(literal)])
+        {
+            if (!watcher.binary() || literal > watcher.blocker)
+            {
+                continue;
+            }
+
+            int binary[2] = {literal, watcher.blocker};
+            bool learnt = watcher.clause_ref == BINARY_LEARNT;
+            ClauseRef clause_ref = arena.allocate(binary, 2, learnt);
+            if (learnt)
+            {
+                arena[clause_ref].tier = ClauseTier::core;
+                arena[clause_ref].lbd = 2;
+                learnts[ClauseTier::core].push_back(clause_ref);
+            }
+            else
+            {
+                clauses.push_back(clause_ref);
+            }
+        }
+    }
+
+    for (auto &watch_list : watches)
+    {
+        watch_list.clear();
+    }
+    for (auto &watch_list : ternary_watches)
+    {
+        watch_list.clear();
+    }
+    attached_clause_count = 0;
+
+    // Without watches, decision level 0 is applied to the clauses directly;
+    // only the clauses that lose literals are written
+    auto simplify = [&](ClauseRef clause_ref)
+    {
+        Clause &clause = arena[clause_ref];
+        bool shortened = false;
+        for (int i = 0; i < clause.size(); i++)
+        {
+            int value = SATSolver::literalValue(clause[i]);
+            if (value == 1)
+            {
+                arena.free(clause_ref);
+                return;
+            }
+            shortened = shortened || value == 0;
+        }
+        if (!shortened)
+        {
+            return;
+        }
+
+        clause_ref = SATSolver::ownClause(clause_ref);
+        Clause &own = arena[clause_ref];
+        int size = 0;
+        for (int i = 0; i < own.size(); i++)
+        {
+            if (SATSolver::literalValue(own[i]) == -1)
+            {
+                own[size++] = own[i];
+            }
+        }
+        own.shrink(size);
+    };
+
+    // The copies made by ownClause are added after the clauses visited
+    int clause_count = clauses.size();
+    for (int i = 0; i < clause_count; i++)
+    {
+        if (!arena.deleted(clauses[i]))
+        {
+            simplify(clauses[i]);
+        }
+    }
+    for (int tier = ClauseTier::core; tier <= ClauseTier::local; tier++)
+    {
+        for (ClauseRef clause_ref : learnts[tier])
+        {
+            if (!arena[clause_ref].deleted && arena[clause_ref].tier == tier)
+            {
+                simplify(clause_ref);
+            }
+        }
+    }
+}
+
+ClauseRef SATSolver::ownClause(ClauseRef clause_ref)
+{
+    if (!arena.inBase(clause_ref))
+    {
+        return clause_ref;
+    }
+
+    // The base clause stays in place while the copy is allocated
+    Clause &clause = arena[clause_ref];
+    ClauseRef own_ref = arena.allocate(clause.literals(), clause.size(), false);
+    if (arena.vivified(clause_ref))
+    {
+        arena.markVivified(own_ref);
+    }
+    arena.free(clause_ref);
+    clauses.push_back(own_ref);
+    return own_ref;
+}
+
+void SATSolver::reattachClauses()
+{
+    // Original binary clauses are watched again by attachClauses
+    int j = 0;
+    for (int i = 0; i < clauses.size(); i++)
+    {
+        Clause &clause = arena[clauses[i]];
+        if (arena.deleted(clauses[i]))
+        {
+            continue;
+        }
+
+        if (clause.size() == 2)
+        {
+            pending_binaries.push_back(clause[0]);
+            pending_binaries.push_back(clause[1]);
+            arena.free(clauses[i]);
+        }
+        else
+        {
+            clauses[j++] = clauses[i];
+        }
+    }
+    clauses.resize(j);
+
+    // Learned clauses are watched here; each live one is kept once, in the
+    // list of its tier
+    for (int tier = ClauseTier::core; tier <= ClauseTier::local; tier++)
+    {
+        std::vector<ClauseRef> &tier_learnts = learnts[tier];
+        std::sort(tier_learnts.begin(), tier_learnts.end());
+        tier_learnts.erase(std::unique(tier_learnts.begin(), tier_learnts.end()), tier_learnts.end());
+
+        j = 0;
+        for (int i = 0; i < tier_learnts.size(); i++)
+        {
+            Clause &clause = arena[tier_learnts[i]];
+            if (clause.deleted || clause.tier != tier)
+            {
+                continue;
+            }
+
+            if (clause.size() == 2)
+            {
+                SATSolver::watchBinaryClause(clause[0], clause[1], true);
+                arena.free(tier_learnts[i]);
+            }
+            else
+            {
+                SATSolver::watchClause(tier_learnts[i]);
+                tier_learnts[j++] = tier_learnts[i];
+            }
+        }
+        tier_learnts.resize(j);
+    }
+
+    SATSolver::attachClauses();
+
+    if (arena.wasted() > arena.size() / 5)
+    {
+        SATSolver::garbageCollect();
+    }
+}
+
+bool SATSolver::inprocess()
+{
+    statistics.inprocessing_rounds++;
+    SATSolver::backtrack(0);
+    SATSolver::simplifyDatabase();
+    SATSolver::detachClauses();
+    if (options.substitution)
+    {
+        SATSolver::substituteEquivalentLiterals();
+    }
+    if (options.subsumption && !empty_clause_found)
+    {
+        SATSolver::subsumeClauses();
+    }
+    SATSolver::reattachClauses();
+
+    // Substitution and strengthening may have found new units
+    return !empty_clause_found && SATSolver::unitPropagation() == CLAUSE_UNDEF;
+}
+
+void SATSolver::subsumeClauses()
+{
+    statistics.subsumption_rounds++;
+
+    // Every live clause takes part, with a signature of its variables
+    std::vector<ClauseRef> candidates;
+    for (ClauseRef clause_ref : clauses)
+    {
+        if (!arena.deleted(clause_ref))
+        {
+            candidates.push_back(clause_ref);
+        }
+    }
+    for (int tier = ClauseTier::core; tier <= ClauseTier::local; tier++)
+    {
+        for (ClauseRef clause_ref : learnts[tier])
+        {
+            if (!arena[clause_ref].deleted && arena[clause_ref].tier == tier)
+            {
+                candidates.push_back(clause_ref);
+            }
+        }
+    }
+
+    // Short clauses subsume the most, so they go first; the sizes are
+    // read once, in arena order
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+    std::vector<std::pair<int, ClauseRef>> sized_candidates(candidates.size());
+    for (int i = 0; i < candidates.size(); i++)
+    {
+        sized_candidates[i] = {arena[candidates[i]].size(), candidates[i]};
+    }
+    std::sort(sized_candidates.begin(), sized_candidates.end());
+    for (int i = 0; i < candidates.size(); i++)
+    {
+        candidates[i] = sized_candidates[i].second;
+    }
+    std::vector<std::pair<int, ClauseRef>>().swap(sized_candidates);
+
+    auto signature = [&](ClauseRef clause_ref)
+    {
+        Clause &clause = arena[clause_ref];
+        uint64_t bits = 0;
+        for (int i = 0; i < clause.size(); i++)
+        {
+            bits |= 1ull << (abs(clause[i]) & 63);
+        }
+        return bits;
+    };
+
+    // No clause gains a literal during the round, so the occurrence lists
+    // are laid out once, one after the other: the positions in candidates
+    // of the clauses containing the literal with watch index i are
+    // occurrence_list[occurrence_starts[i]] to occurrence_list[occurrence_starts[i + 1] - 1]
+    std::vector<uint64_t> signatures(candidates.size());
+    std::vector<int> occurrence_starts(2 * variable_count + 3, 0);
+    for (int i = 0; i < candidates.size(); i++)
+    {
+        Clause &clause = arena[candidates[i]];
+        signatures[i] = signature(candidates[i]);
+        for (int k = 0; k < clause.size(); k++)
+        {
+            occurrence_starts[SATSolver::watchIndex(clause[k]) + 1]++;
+        }
+    }
+    for (int i = 1; i < occurrence_starts.size(); i++)
+    {
+        occurrence_starts[i] += occurrence_starts[i - 1];
+    }
+
+    std::vector<int> occurrence_list(occurrence_starts.back());
+    std::vector<int> occurrence_ends(occurrence_starts.begin(), occurrence_starts.end() - 1);
+    for (int i = 0; i < candidates.size(); i++)
+    {
+        Clause &clause = arena[candidates[i]];
+        for (int k = 0; k < clause.size(); k++)
+        {
+            occurrence_list[occurrence_ends[SATSolver::watchIndex(clause[k])]++] = i;
+        }
+    }
+    std::vector<int>().swap(occurrence_ends);
+
+    auto occurrence_count = [&](int literal)
+    {
+        return occurrence_starts[SATSolver::watchIndex(literal) + 1] - occurrence_starts[SATSolver::watchIndex(literal)];
+    };
+
+    // Strengthened clauses are tried again as subsuming clauses
+    std::vector<int> queue(candidates.size());
+    std::vector<char> queued(candidates.size(), 1);
+    for (int i = 0; i < candidates.size(); i++)
+    {
+        queue[i] = i;
+    }
+
+    long long effort = 0;
+    for (int q = 0; q < queue.size() && effort < options.subsumption_effort && !empty_clause_found; q++)
+    {
+        int index = queue[q];
+        queued[index] = 0;
+        ClauseRef clause_ref = candidates[index];
+        Clause &clause = arena[clause_ref];
+        if (arena.deleted(clause_ref) || clause.size() > options.subsumption_clause_size)
+        {
+            continue;
+        }
+
+        // Only the clauses containing the variable with the fewest
+        // occurrences can contain all of the clause
+        int pivot = clause[0];
+        for (int i = 1; i < clause.size(); i++)
+        {
+            int literal = clause[i];
+            if (occurrence_count(literal) + occurrence_count(-literal) < occurrence_count(pivot) + occurrence_count(-pivot))
+            {
+                pivot = literal;
+            }
+        }
+
+        int size = clause.size();
+        bool learnt = clause.learnt;
+        for (int i = 0; i < size; i++)
+        {
+            literal_marks[SATSolver::watchIndex(clause[i])] = 1;
+        }
+
+        for (int polarity = 0; polarity < 2; polarity++)
+        {
+            int watch_index = SATSolver::watchIndex(polarity ? -pivot : pivot);
+            effort += occurrence_starts[watch_index + 1] - occurrence_starts[watch_index];
+            for (int position = occurrence_starts[watch_index]; position < occurrence_starts[watch_index + 1]; position++)
+            {
+                int other_index = occurrence_list[position];
+                // The signatures rule out most clauses without reading them
+                if (other_index == index || (signatures[index] & ~signatures[other_index]) != 0)
+                {
+                    continue;
+                }
+
+                ClauseRef other_ref = candidates[other_index];
+                Clause &other = arena[other_ref];
+                if (arena.deleted(other_ref) || other.size() < size)
+                {
+                    continue;
+                }
+
+                effort += other.size();
+                int removed;
+                if (!SATSolver::subsumedBy(other_ref, size, removed))
+                {
+                    continue;
+                }
+
+                if (removed == 0)
+                {
+                    // An original clause is only implied by a learned one
+                    // as long as the learned clause is kept
+                    if (!learnt || other.learnt)
+                    {
+                        arena.free(other_ref);
+                        statistics.subsumed_clauses++;
+                    }
+                    continue;
+                }
+
+                // The resolvent of the two clauses is the other clause
+                // without the removed literal, which it replaces
+                other_ref = SATSolver::ownClause(other_ref);
+                candidates[other_index] = other_ref;
+                Clause &strengthened = arena[other_ref];
+                int other_size = 0;
+                for (int k = 0; k < strengthened.size(); k++)
+                {
+                    if (strengthened[k] != removed)
+                    {
+                        strengthened[other_size++] = strengthened[k];
+                    }
+                }
+                strengthened.shrink(other_size);
+                signatures[other_index] = signature(other_ref);
+                statistics.strengthened_clauses++;
+
+                // Two opposite units resolve into the empty clause
+                if (other_size <= 1)
+                {
+                    int value = other_size == 0 ? 0 : SATSolver::literalValue(strengthened[0]);
+                    if (value == 0)
+                    {
+                        empty_clause_found = true;
+                    }
+                    else if (value == -1)
+                    {
+                        SATSolver::assignLiteral(strengthened[0], CLAUSE_UNDEF);
+                    }
+                    arena.free(other_ref);
+                }
+                else if (!queued[other_index])
+                {
+                    queued[other_index] = 1;
+                    queue.push_back(other_index);
+                }
+            }
+        }
+
+        Clause &marked = arena[clause_ref];
+        for (int i = 0; i < marked.size(); i++)
+        {
+            literal_marks[SATSolver::watchIndex(marked[i])] = 0;
+        }
+    }
+}
+
+bool SATSolver::subsumedBy(ClauseRef clause_ref, int marked_size, int &removed)
+{
+    Clause &clause = arena[clause_ref];
+    int found = 0;
+    removed = 0;
+    for (int i = 0; i < clause.size(); i++)
+    {
+        int literal = clause[i];
+        if (literal_marks[SATSolver::watchIndex(literal)])
+        {
+            found++;
+        }
+        else if (literal_marks[SATSolver::watchIndex(-literal)])
+        {
+            // A second opposite literal makes the resolvent a tautology
+            if (removed != 0)
+            {
+                return false;
+            }
+            removed = literal;
+            found++;
+        }
+    }
+    return found == marked_size;
+}
+
+void SATSolver::substituteEquivalentLiterals()
+{
+    // Every binary clause (a, b) gives the implications -a -> b and -b -> a
+    std::vector<int> binaries;
+    auto collectBinary = [&](ClauseRef clause_ref)
+    {
+        Clause &clause = arena[clause_ref];
+        if (clause.size() == 2)
+        {
+            binaries.push_back(clause[0]);
+            binaries.push_back(clause[1]);
+        }
+    };
+    for (ClauseRef clause_ref : clauses)
+    {
+        if (!arena.deleted(clause_ref))
+        {
+            collectBinary(clause_ref);
+        }
+    }
+    for (int tier = ClauseTier::core; tier <= ClauseTier::local; tier++)
+    {
+        for (ClauseRef clause_ref : learnts[tier])
+        {
+            if (!arena[clause_ref].deleted && arena[clause_ref].tier == tier)
+            {
+                collectBinary(clause_ref);
+            }
+        }
+    }
+    if (binaries.empty())
+    {
+        return;
+    }
+
+    // The implications of each literal are stored one literal after the other
+    int node_count = 2 * variable_count + 2;
+    std::vector<int> edge_starts(node_count + 1, 0);
+    for (int literal : binaries)
+    {
+        edge_starts[SATSolver::watchIndex(-literal) + 1]++;
+    }
+    for (int i = 0; i < node_count; i++)
+    {
+        edge_starts[i + 1] += edge_starts[i];
+    }
+    std::vector<int> edges(edge_starts.back());
+    std::vector<int> edge_ends(edge_starts.begin(), edge_starts.end() - 1);
+    for (int i = 0; i < binaries.size(); i += 2)
+    {
+        edges[edge_ends[SATSolver::watchIndex(-binaries[i])]++] = binaries[i + 1];
+        edges[edge_ends[SATSolver::watchIndex(-binaries[i + 1])]++] = binaries[i];
+    }
+    std::vector<int>().swap(binaries);
+    std::vector<int>().swap(edge_ends);
+
+    // Tarjan's algorithm, with an explicit stack of the literals being
+    // visited and the position of their next implication
+    std::vector<int> indices(node_count, -1);
+    std::vector<int> lowlinks(node_count, 0);
+    std::vector<int> representatives(node_count, 0);
+    std::vector<int> component_stack;
+    std::vector<char> on_stack(node_count, 0);
+    std::vector<std::pair<int, int>> visit_stack;
+    int next_index = 0;
+
+    for (int root = -variable_count; root <= variable_count && !empty_clause_found; root++)
+    {
+        int root_node = SATSolver::watchIndex(root);
+        if (root == 0 || indices[root_node] != -1 || values[abs(root)] != -1 || eliminated[abs(root)])
+        {
+            continue;
+        }
+
+        indices[root_node] = lowlinks[root_node] = next_index++;
+        component_stack.push_back(root);
+        on_stack[root_node] = 1;
+        visit_stack.push_back({root, edge_starts[root_node]});
+
+        while (!visit_stack.empty())
+        {
+            int literal = visit_stack.back().first;
+            int node = SATSolver::watchIndex(literal);
+            int edge = visit_stack.back().second;
+
+            // Visit the next implication of the literal
+            if (edge < edge_starts[node + 1])
+            {
+                visit_stack.back().second++;
+                int implied = edges[edge];
+                int implied_node = SATSolver::watchIndex(implied);
+                if (indices[implied_node] == -1)
+                {
+                    indices[implied_node] = lowlinks[implied_node] = next_index++;
+                    component_stack.push_back(implied);
+                    on_stack[implied_node] = 1;
+                    visit_stack.push_back({implied, edge_starts[implied_node]});
+                }
+                else if (on_stack[implied_node])
+                {
+                    lowlinks[node] = std::min(lowlinks[node], indices[implied_node]);
+                }
+                continue;
+            }
+
+            visit_stack.pop_back();
+            if (!visit_stack.empty())
+            {
+                int parent_node = SATSolver::watchIndex(visit_stack.back().first);
+                lowlinks[parent_node] = std::min(lowlinks[parent_node], lowlinks[node]);
+            }
+            if (lowlinks[node] != indices[node])
+            {
+                continue;
+            }
+
+            // The literal is the first of a component of equivalent literals;
+            // the negated component has the negated representative, otherwise
+            // the literal with the smallest variable represents them
+            int component_start = component_stack.size();
+            do
+            {
+                component_start--;
+                on_stack[SATSolver::watchIndex(component_stack[component_start])] = 0;
+            } while (component_stack[component_start] != literal);
+
+            int representative = component_stack[component_start];
+            int negated_representative = representatives[SATSolver::watchIndex(-representative)];
+            for (int i = component_start; i < component_stack.size(); i++)
+            {
+                int member = component_stack[i];
+                literal_marks[SATSolver::watchIndex(member)] = 1;
+                if (abs(member) < abs(representative))
+                {
+                    representative = member;
+                }
+            }
+            if (negated_representative != 0)
+            {
+                representative = -negated_representative;
+            }
+
+            // A literal equivalent to its negation makes the formula unsatisfiable
+            for (int i = component_start; i < component_stack.size(); i++)
+            {
+                int member = component_stack[i];
+                if (literal_marks[SATSolver::watchIndex(-member)])
+                {
+                    empty_clause_found = true;
+                }
+                representatives[SATSolver::watchIndex(member)] = representative;
+            }
+            for (int i = component_start; i < component_stack.size(); i++)
+            {
+                literal_marks[SATSolver::watchIndex(component_stack[i])] = 0;
+            }
+            component_stack.resize(component_start);
+        }
+    }
+    if (empty_clause_found)
+    {
+        return;
+    }
+
+    // Every other variable of a component is replaced by the representative;
+    // its two binary clauses go to the extension stack to restore its value.
+    // Frozen variables keep their literals
+    int substituted_count = 0;
+    for (int variable = 1; variable <= variable_count; variable++)
+    {
+        int representative = representatives[SATSolver::watchIndex(variable)];
+        if (frozen[variable])
+        {
+            representatives[SATSolver::watchIndex(variable)] = 0;
+            representatives[SATSolver::watchIndex(-variable)] = 0;
+        }
+        if (representative == 0 || abs(representative) == variable || frozen[variable])
+        {
+            continue;
+        }
+
+        extension_stack.push_back(variable);
+        extension_stack.push_back(-representative);
+        extension_stack.push_back(2);
+        extension_stack.push_back(-variable);
+        extension_stack.push_back(representative);
+        extension_stack.push_back(2);
+        eliminated[variable] = 1;
+        eliminated_count++;
+        substituted_count++;
+    }
+    statistics.substituted_variables += substituted_count;
+    if (substituted_count == 0)
+    {
+        return;
+    }
+
+    // Rewrite the clauses with the representatives, dropping the duplicate
+    // literals and the clauses that become tautologies
+    auto substitute = [&](ClauseRef clause_ref)
+    {
+        Clause &clause = arena[clause_ref];
+        bool changed = false;
+        for (int i = 0; i < clause.size() && !changed; i++)
+        {
+            int representative = representatives[SATSolver::watchIndex(clause[i])];
+            changed = representative != 0 && representative != clause[i];
+        }
+        if (!changed)
+        {
+            return;
+        }
+
+        // A base clause is rewritten in a copy of its own
+        clause_ref = SATSolver::ownClause(clause_ref);
+        Clause &own = arena[clause_ref];
+        int size = 0;
+        bool tautology = false;
+        for (int i = 0; i < own.size(); i++)
+        {
+            int literal = own[i];
+            int representative = representatives[SATSolver::watchIndex(literal)];
+            if (representative != 0)
+            {
+                literal = representative;
+            }
+
+            if (literal_marks[SATSolver::watchIndex(-literal)])
+            {
+                tautology = true;
+            }
+            else if (!literal_marks[SATSolver::watchIndex(literal)])
+            {
+                literal_marks[SATSolver::watchIndex(literal)] = 1;
+                own[size++] = literal;
+            }
+        }
+        for (int i = 0; i < size; i++)
+        {
+            literal_marks[SATSolver::watchIndex(own[i])] = 0;
+        }
+
+        if (tautology)
+        {
+            arena.free(clause_ref);
+            return;
+        }
+
+        own.shrink(size);
+        if (size == 1)
+        {
+            int value = SATSolver::literalValue(own[0]);
+            if (value == 0)
+            {
+                empty_clause_found = true;
+            }
+            else if (value == -1)
+            {
+                SATSolver::assignLiteral(own[0], CLAUSE_UNDEF);
+            }
+            arena.free(clause_ref);
+        }
+    };
+
+    // The copies made by ownClause are added after the clauses visited
+    int clause_count = clauses.size();
+    for (int i = 0; i < clause_count; i++)
+    {
+        if (!arena.deleted(clauses[i]))
+        {
+            substitute(clauses[i]);
+        }
+    }
+    for (int tier = ClauseTier::core; tier <= ClauseTier::local; tier++)
+    {
+        for (ClauseRef clause_ref : learnts[tier])
+        {
+            if (!arena[clause_ref].deleted && arena[clause_ref].tier == tier)
+            {
+                substitute(clause_ref);
+            }
+        }
+    }
+}
+
+bool SATSolver::probeLiterals()
+{
+    statistics.probing_rounds++;
+    SATSolver::backtrack(0);
+
+    // The round may spend a share of the propagations the search made
+    // since the previous round
+    long long search_propagations = SATSolver::searchPropagations();
+    long long budget = options.probing_effort * (search_propagations - probed_search_propagations);
+    probed_search_propagations = search_propagations;
+    long long start = statistics.propagations;
+
+    // A literal has a binary clause watching its negation if it implies
+    // another literal, and one watching itself if another literal implies it
+    auto binaryWatched = [&](int literal)
+    {
+        for (Watcher watcher : watches[SATSolver::watchIndex(literal)])
+        {
+            if (watcher.binary())
+            {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    // Probes are decisions the search never made, so they must not change
+    // the saved phases
+    std::vector<signed char> phases = saved_phases;
+    std::vector<int> implied;
+    std::vector<int> units;
+    bool consistent = true;
+
+    for (int step = 0; step < variable_count && statistics.propagations - start < budget; step++)
+    {
+        int variable = probe_variable;
+        probe_variable = probe_variable % variable_count + 1;
+        if (values[variable] != -1 || eliminated[variable])
+        {
+            continue;
+        }
+
+        // Probing a root covers everything the literals it implies would
+        // find, so only variables with a root literal are probed
+        int root = 0;
+        if (binaryWatched(-variable) && !binaryWatched(variable))
+        {
+            root = variable;
+        }
+        else if (binaryWatched(variable) && !binaryWatched(-variable))
+        {
+            root = -variable;
+        }
+        if (root == 0)
+        {
+            continue;
+        }
+
+        units.clear();
+        if (!SATSolver::probeLiteral(root))
+        {
+            units.push_back(-root);
+            statistics.failed_literals++;
+        }
+        else
+        {
+            // Remember what the root implies, then probe its negation
+            implied.assign(trail.begin() + trail_lim[0] + 1, trail.end());
+            SATSolver::backtrack(0);
+            for (int literal : implied)
+            {
+                literal_marks[SATSolver::watchIndex(literal)] = 1;
+            }
+
+            if (!SATSolver::probeLiteral(-root))
+            {
+                units.push_back(root);
+                statistics.failed_literals++;
+            }
+            else
+            {
+                for (int i = trail_lim[0] + 1; i < trail.size(); i++)
+                {
+                    if (literal_marks[SATSolver::watchIndex(trail[i])] & 1)
+                    {
+                        units.push_back(trail[i]);
+                        statistics.implied_units++;
+                    }
+                }
+            }
+
+            for (int literal : implied)
+            {
+                literal_marks[SATSolver::watchIndex(literal)] = 0;
+            }
+        }
+        SATSolver::backtrack(0);
+
+        // The units hold in every model, so they go to decision level 0
+        for (int unit : units)
+        {
+            int value = SATSolver::literalValue(unit);
+            if (value == 0)
+            {
+                consistent = false;
+                break;
+            }
+            else if (value == -1)
+            {
+                SATSolver::assignLiteral(unit, CLAUSE_UNDEF);
+            }
+        }
+
+        if (!consistent || SATSolver::unitPropagation() != CLAUSE_UNDEF)
+        {
+            consistent = false;
+            break;
+        }
+    }
+
+    saved_phases = phases;
+    statistics.probing_propagations += statistics.propagations - start;
+    return consistent;
+}
+
+bool SATSolver::probeLiteral(int literal)
+{
+    statistics.probed_literals++;
+    SATSolver::newDecisionLevel();
+    SATSolver::assignLiteral(literal, CLAUSE_UNDEF);
+    if (SATSolver::unitPropagation() != CLAUSE_UNDEF)
+    {
+        return false;
+    }
+
+    // The literals the probe already implies through a binary clause need
+    // no resolvent
+    std::vector<Watcher> &implications = watches[SATSolver::watchIndex(-literal)];
+    for (Watcher watcher : implications)
+    {
+        if (watcher.binary())
+        {
+            literal_marks[SATSolver::watchIndex(watcher.blocker)] |= 2;
+        }
+    }
+
+    // Every other false literal of a propagating clause is implied by the
+    // probe, so the probe implies the propagated literal by itself
+    int probe_size = trail.size();
+    for (int i = trail_lim[0] + 1; i < probe_size; i++)
+    {
+        int implied_literal = trail[i];
+        ClauseRef reason = reasons[abs(implied_literal)];
+        if (isBinaryReason(reason) || literal_marks[SATSolver::watchIndex(implied_literal)] & 2)
+        {
+            continue;
+        }
+
+        SATSolver::watchBinaryClause(-literal, implied_literal, true);
+        statistics.hyper_binary_resolvents++;
+    }
+
+    for (Watcher watcher : implications)
+    {
+        literal_marks[SATSolver::watchIndex(watcher.blocker)] &= ~2;
+    }
+    return true;
+}
+
+bool SATSolver::vivifyClauses()
+{
+    statistics.vivification_rounds++;
+    SATSolver::backtrack(0);
+    SATSolver::simplifyDatabase();
+
+    // The round may spend a share of the propagations the search made
+    // since the previous round
+    long long search_propagations = SATSolver::searchPropagations();
+    long long budget = options.vivification_effort * (search_propagations - vivified_search_propagations);
+    vivified_search_propagations = search_propagations;
+    long long start = statistics.propagations;
+
+    // The candidates come in classes: the tier2 clauses used since the
+    // last reduction, the other tier2 clauses and the original clauses;
+    // core clauses are kept forever anyway, so the budget goes elsewhere
+    std::vector<ClauseRef> candidates;
+    std::vector<int> class_ends;
+    auto collect = [&](std::vector<ClauseRef> &clause_refs, int tier)
+    {
+        int class_start = candidates.size();
+        for (ClauseRef clause_ref : clause_refs)
+        {
+            Clause &clause = arena[clause_ref];
+            if (!arena.deleted(clause_ref) && !arena.vivified(clause_ref) && clause.size() > 2 && (!clause.learnt || clause.tier == tier))
+            {
+                candidates.push_back(clause_ref);
+            }
+        }
+        std::sort(candidates.begin() + class_start, candidates.end());
+        candidates.erase(std::unique(candidates.begin() + class_start, candidates.end()), candidates.end());
+    };
+    collect(learnts[ClauseTier::tier2], ClauseTier::tier2);
+    auto unused = std::stable_partition(candidates.begin(), candidates.end(), [this](ClauseRef clause_ref)
+                                        { return arena[clause_ref].used; });
+    class_ends.push_back(unused - candidates.begin());
+    class_ends.push_back(candidates.size());
+    collect(clauses, ClauseTier::core);
+    class_ends.push_back(candidates.size());
+
+    // Every clause is falsified from its most frequent literal on, and the
+    // clauses of a class are sorted by those literals, so that a clause can
+    // keep the decisions it shares with the previous one
+    std::vector<int> literal_counts(2 * variable_count + 2, 0);
+    for (ClauseRef clause_ref : candidates)
+    {
+        Clause &clause = arena[clause_ref];
+        for (int i = 0; i < clause.size(); i++)
+        {
+            literal_counts[SATSolver::watchIndex(clause[i])]++;
+        }
+    }
+    auto before = [&](int a, int b)
+    {
+        int count_a = literal_counts[SATSolver::watchIndex(a)];
+        int count_b = literal_counts[SATSolver::watchIndex(b)];
+        return count_a > count_b || (count_a == count_b && a < b);
+    };
+
+    std::vector<int> candidate_starts(candidates.size() + 1, 0);
+    std::vector<int> candidate_literals;
+    for (int c = 0; c < candidates.size(); c++)
+    {
+        Clause &clause = arena[candidates[c]];
+        candidate_literals.insert(candidate_literals.end(), clause.literals(), clause.literals() + clause.size());
+        std::sort(candidate_literals.begin() + candidate_starts[c], candidate_literals.end(), before);
+        candidate_starts[c + 1] = candidate_literals.size();
+    }
+
+    std::vector<int> schedule(candidates.size());
+    for (int c = 0; c < candidates.size(); c++)
+    {
+        schedule[c] = c;
+    }
+    int class_start = 0;
+    for (int class_end : class_ends)
+    {
+        std::sort(schedule.begin() + class_start, schedule.begin() + class_end, [&](int a, int b)
+                  { return std::lexicographical_compare(candidate_literals.begin() + candidate_starts[a], candidate_literals.begin() + candidate_starts[a + 1],
+                                                        candidate_literals.begin() + candidate_starts[b], candidate_literals.begin() + candidate_starts[b + 1], before); });
+        class_start = class_end;
+    }
+
+    // Vivification decisions are not search decisions, so they must not
+    // change the saved phases
+    std::vector<signed char> phases = saved_phases;
+    std::vector<int> literals;
+    std::vector<ClauseRef> shortened;
+    std::vector<int> shortened_literals;
+    int removed_count = 0;
+
+    for (int s = 0; s < schedule.size() && statistics.propagations - start < budget; s++)
+    {
+        ClauseRef clause_ref = candidates[schedule[s]];
+        int *sorted = &candidate_literals[candidate_starts[schedule[s]]];
+        int size = candidate_starts[schedule[s] + 1] - candidate_starts[schedule[s]];
+        Clause &clause = arena[clause_ref];
+        arena.markVivified(clause_ref);
+        statistics.vivified_clauses++;
+
+        // Keep the decisions that falsify the first literals of the clause,
+        // skipping the literals they falsify
+        int level = 0;
+        for (int i = 0; i < size && level < SATSolver::decisionLevel(); i++)
+        {
+            int literal = sorted[i];
+            if (trail[trail_lim[level]] == -literal)
+            {
+                level++;
+            }
+            else if (SATSolver::literalValue(literal) != 0 || levels[abs(literal)] > level)
+            {
+                break;
+            }
+        }
+        SATSolver::backtrack(level);
+
+        // Falsify the literals one by one: a literal that becomes false is
+        // implied false by the ones before it and can be dropped, and a
+        // literal that becomes true or a conflict makes the rest redundant
+        literals.clear();
+        ClauseRef true_reason = CLAUSE_UNDEF;
+        for (int i = 0; i < size; i++)
+        {
+            int literal = sorted[i];
+            int value = SATSolver::literalValue(literal);
+            if (value == 0)
+            {
+                // The kept decisions falsify literals of the clause too
+                if (levels[abs(literal)] > 0 && reasons[abs(literal)] == CLAUSE_UNDEF)
+                {
+                    literals.push_back(literal);
+                }
+                continue;
+            }
+
+            literals.push_back(literal);
+            if (value == 1)
+            {
+                true_reason = reasons[abs(literal)];
+                break;
+            }
+
+            if (i + 1 < size)
+            {
+                SATSolver::newDecisionLevel();
+                SATSolver::assignLiteral(-literal, CLAUSE_UNDEF);
+                if (SATSolver::unitPropagation() != CLAUSE_UNDEF)
+                {
+                    SATSolver::backtrack(SATSolver::decisionLevel() - 1);
+                    break;
+                }
+            }
+        }
+
+        if (literals.size() < size)
+        {
+            shortened.push_back(clause_ref);
+            shortened_literals.insert(shortened_literals.end(), literals.begin(), literals.end());
+            shortened_literals.push_back(0);
+            statistics.vivified_literals += size - literals.size();
+            arena.free(clause_ref);
+        }
+        else if (clause.learnt && true_reason != CLAUSE_UNDEF && true_reason != clause_ref)
+        {
+            // The other clauses imply the whole learned clause
+            arena.free(clause_ref);
+            removed_count++;
+        }
+    }
+    SATSolver::backtrack(0);
+
+    saved_phases = phases;
+    statistics.vivification_propagations += statistics.propagations - start;
+    statistics.vivification_removed_clauses += removed_count;
+    if (shortened.empty() && removed_count == 0)
+    {
+        return true;
+    }
+
+    // Forget the freed clauses, then add the shortened ones in their place
+    auto dropDeleted = [&](std::vector<ClauseRef> &clause_refs)
+    {
+        int j = 0;
+        for (int i = 0; i < clause_refs.size(); i++)
+        {
+            if (!arena.deleted(clause_refs[i]))
+            {
+                clause_refs[j++] = clause_refs[i];
+            }
+        }
+        clause_refs.resize(j);
+    };
+    dropDeleted(clauses);
+    for (auto &tier_learnts : learnts)
+    {
+        dropDeleted(tier_learnts);
+    }
+    SATSolver::purgeWatches();
+
+    std::vector<int> units;
+    int position = 0;
+    for (ClauseRef old_ref : shortened)
+    {
+        int size = 0;
+        while (shortened_literals[position + size] != 0)
+        {
+            size++;
+        }
+        int *shortened_clause = &shortened_literals[position];
+        position += size + 1;
+
+        Clause &old_clause = arena[old_ref];
+        bool learnt = old_clause.learnt;
+        int tier = old_clause.tier;
+        int lbd = std::min<int>(old_clause.lbd, size);
+        float activity = old_clause.activity;
+
+        if (size == 1)
+        {
+            units.push_back(shortened_clause[0]);
+        }
+        else if (size == 2)
+        {
+            SATSolver::watchBinaryClause(shortened_clause[0], shortened_clause[1], learnt);
+        }
+        else
+        {
+            ClauseRef clause_ref = arena.allocate(shortened_clause, size, learnt);
+            Clause &clause = arena[clause_ref];
+            clause.vivified = 1;
+            if (learnt)
+            {
+                clause.tier = tier;
+                clause.lbd = lbd;
+                clause.activity = activity;
+                learnts[tier].push_back(clause_ref);
+            }
+            else
+            {
+                clauses.push_back(clause_ref);
+            }
+            SATSolver::watchClause(clause_ref);
+        }
+    }
+    attached_clause_count = clauses.size();
+
+    // The units are decision level 0 assignments
+    for (int unit : units)
+    {
+        int value = SATSolver::literalValue(unit);
+        if (value == 0)
+        {
+            return false;
+        }
+        else if (value == -1)
+        {
+            SATSolver::assignLiteral(unit, CLAUSE_UNDEF);
+        }
+    }
+
+    if (arena.wasted() > arena.size() / 5)
+    {
+        SATSolver::garbageCollect();
+    }
+
+    return SATSolver::unitPropagation() == CLAUSE_UNDEF;
+}
+
+long long SATSolver::searchPropagations()
+{
+    return statistics.propagations - statistics.probing_propagations - statistics.vivification_propagations - statistics.lookahead_propagations;
+}
+
+bool SATSolver::sharedBefore(const int *literals, int size)
+{
+    // Summing the mixed literals makes the hash independent of their order
+    uint64_t hash = size;
+    for (int i = 0; i < size; i++)
+    {
+        uint64_t mixed = (uint64_t)SATSolver::watchIndex(literals[i]) * 0x9e3779b97f4a7c15ull;
+        mixed ^= mixed >> 29;
+        mixed *= 0xbf58476d1ce4e5b9ull;
+        hash += mixed ^ (mixed >> 32);
+    }
+    hash |= 1;
+
+    uint64_t &entry = shared_hashes[hash & (shared_hashes.size() - 1)];
+    if (entry == hash)
+    {
+        return true;
+    }
+    entry = hash;
+    return false;
+}
+
+void SATSolver::exportClause(const int *literals, int size, int lbd)
+{
+    // Adjust the LBD limit so that the traffic stays close to the target
+    if (statistics.conflicts >= next_share_update)
+    {
+        long long exported = statistics.exported_clauses - shared_exports;
+        if (exported < options.share_target / 2 && share_lbd < options.share_max_lbd)
+        {
+            share_lbd++;
+        }
+        else if (exported > options.share_target && share_lbd > options.share_lbd)
+        {
+            share_lbd--;
+        }
+        shared_exports = statistics.exported_clauses;
+        next_share_update = statistics.conflicts + options.share_interval;
+    }
+
+    if (size > std::min(options.share_clause_size, SHARED_CLAUSE_SIZE) || (size > 1 && lbd > share_lbd))
+    {
+        return;
+    }
+
+    if (SATSolver::sharedBefore(literals, size))
+    {
+        statistics.duplicate_shared_clauses++;
+        return;
+    }
+
+    exchange->publish(exchange_worker, literals, size, lbd);
+    statistics.exported_clauses++;
+}
+
+bool SATSolver::importClauses()
+{
+    SATSolver::backtrack(0);
+    shared_clauses.clear();
+    statistics.lost_shared_clauses += exchange->collect(exchange_worker, shared_clauses);
+
+    for (int i = 0; i < shared_clauses.size(); i += shared_clauses[i] + 2)
+    {
+        int size = shared_clauses[i];
+        int lbd = shared_clauses[i + 1];
+        int *literals = &shared_clauses[i + 2];
+        if (SATSolver::sharedBefore(literals, size))
+        {
+            statistics.duplicate_shared_clauses++;
+            continue;
+        }
+
+        // The other solvers may still use the variables removed here, and
+        // only the unassigned literals are kept
+        added_clause.clear();
+        bool skipped = false;
+        for (int k = 0; k < size && !skipped; k++)
+        {
+            int value = SATSolver::literalValue(literals[k]);
+            skipped = eliminated[abs(literals[k])] || value == 1;
+            if (value == -1)
+            {
+                added_clause.push_back(literals[k]);
+            }
+        }
+        if (skipped)
+        {
+            continue;
+        }
+        statistics.imported_clauses++;
+
+        // A clause false at decision level 0 makes the formula unsatisfiable
+        if (added_clause.empty())
+        {
+            return false;
+        }
+
+        // Units are decision level 0 assignments and binary clauses only
+        // live in the watch lists, like learned ones
+        if (added_clause.size() == 1)
+        {
+            SATSolver::assignLiteral(added_clause[0], CLAUSE_UNDEF);
+            continue;
+        }
+        if (added_clause.size() == 2)
+        {
+            SATSolver::watchBinaryClause(added_clause[0], added_clause[1], true);
+            continue;
+        }
+
+        lbd = std::min(lbd, (int)added_clause.size() - 1);
+        ClauseRef clause_ref = arena.allocate(added_clause.data(), added_clause.size(), true);
+        Clause &clause = arena[clause_ref];
+        clause.lbd = lbd;
+        clause.tier = lbd <= options.core_lbd ? ClauseTier::core : lbd <= options.tier2_lbd ? ClauseTier::tier2 : ClauseTier::local;
+        clause.imported = 1;
+        learnts[clause.tier].push_back(clause_ref);
+        SATSolver::bumpClause(clause_ref);
+        SATSolver::watchClause(clause_ref);
+    }
+
+    return SATSolver::unitPropagation() == CLAUSE_UNDEF;
+}
+
+void SATSolver::eliminateVariables()
+{
+    // Count the occurrences of every literal first, so that each list is
+    // allocated once
+    std::vector<int> occurrence_counts(2 * variable_count + 2, 0);
+    for (ClauseRef clause_ref : clauses)
+    {
+        Clause &clause = arena[clause_ref];
+        for (int i = 0; i < clause.size() && !arena.deleted(clause_ref); i++)
+        {
+            occurrence_counts[SATSolver::watchIndex(clause[i])]++;
+        }
+    }
+
+    // Leave some room for the resolvents, which are added to the lists of
+    // the variables around the eliminated ones
+    occurrences.assign(2 * variable_count + 2, std::vector<ClauseRef>());
+    for (int i = 0; i < occurrences.size(); i++)
+    {
+        occurrences[i].reserve(occurrence_counts[i] + occurrence_counts[i] / 2 + 2);
+    }
+
+    // The units found before, by subsumption, are applied first
+    int head = 0;
+    for (ClauseRef clause_ref : clauses)
+    {
+        Clause &clause = arena[clause_ref];
+        if (arena.deleted(clause_ref))
+        {
+            continue;
+        }
+
+        for (int i = 0; i < clause.size(); i++)
+        {
+            occurrences[SATSolver::watchIndex(clause[i])].push_back(clause_ref);
+        }
+
+        // Unit clauses are assigned before any variable is eliminated
+        if (clause.size() == 1)
+        {
+            int value = SATSolver::literalValue(clause[0]);
+            if (value == 0)
+            {
+                empty_clause_found = true;
+            }
+            else if (value == -1)
+            {
+                SATSolver::assignLiteral(clause[0], CLAUSE_UNDEF);
+            }
+        }
+    }
+
+    // Try the variables with the fewest occurrences first, then the
+    // variables whose clauses changed since they were tried
+    std::vector<int> candidates;
+    std::vector<char> queued(variable_count + 1, 1);
+    for (int variable = 1; variable <= variable_count; variable++)
+    {
+        candidates.push_back(variable);
+    }
+    std::stable_sort(candidates.begin(), candidates.end(), [&](int a, int b)
+                     { return occurrence_counts[2 * a] + occurrence_counts[2 * a + 1] <
+                              occurrence_counts[2 * b] + occurrence_counts[2 * b + 1]; });
+
+    long long effort = 0;
+    for (int i = 0; i < candidates.size() && !empty_clause_found && effort < options.elimination_effort; i++)
+    {
+        if (!SATSolver::propagateOccurrences(head))
+        {
+            break;
+        }
+
+        int variable = candidates[i];
+        queued[variable] = 0;
+        if (values[variable] != -1 || eliminated[variable] || frozen[variable])
+        {
+            continue;
+        }
+
+        int resolvent_start = clauses.size();
+        if (!SATSolver::eliminateVariable(variable, effort))
+        {
+            break;
+        }
+
+        // The variables of the resolvents may now be cheaper to eliminate
+        for (int k = resolvent_start; k < clauses.size(); k++)
+        {
+            Clause &clause = arena[clauses[k]];
+            for (int j = 0; j < clause.size(); j++)
+            {
+                if (!queued[abs(clause[j])])
+                {
+                    queued[abs(clause[j])] = 1;
+                    candidates.push_back(abs(clause[j]));
+                }
+            }
+        }
+    }
+    SATSolver::propagateOccurrences(head);
+    std::vector<std::vector<ClauseRef>>().swap(occurrences);
+}
+
+bool SATSolver::propagateOccurrences(int &head)
+{
+    while (head < trail.size() && !empty_clause_found)
+    {
+        int literal = trail[head++];
+
+        // The clauses containing the literal are satisfied
+        for (ClauseRef clause_ref : occurrences[SATSolver::watchIndex(literal)])
+        {
+            arena.free(clause_ref);
+        }
+        occurrences[SATSolver::watchIndex(literal)].clear();
+
+        // The clauses containing its negation lose it
+        for (ClauseRef clause_ref : occurrences[SATSolver::watchIndex(-literal)])
+        {
+            if (arena.deleted(clause_ref))
+            {
+                continue;
+            }
+
+            // A base clause loses the literal in a copy of its own, which
+            // takes its place in the occurrence lists of its other literals
+            bool copied = arena.inBase(clause_ref);
+            clause_ref = SATSolver::ownClause(clause_ref);
+            Clause &clause = arena[clause_ref];
+            int size = 0;
+            for (int i = 0; i < clause.size(); i++)
+            {
+                if (clause[i] != -literal)
+                {
+                    clause[size++] = clause[i];
+                }
+            }
+            clause.shrink(size);
+            for (int i = 0; i < size && copied; i++)
+            {
+                occurrences[SATSolver::watchIndex(clause[i])].push_back(clause_ref);
+            }
+
+            // A clause left with one literal is a new unit, unless that
+            // literal is already true and will satisfy it
+            int value = size == 0 ? 0 : SATSolver::literalValue(clause[0]);
+            if (size <= 1 && value == 0)
+            {
+                empty_clause_found = true;
+                return false;
+            }
+            else if (size == 1 && value == -1)
+            {
+                SATSolver::assignLiteral(clause[0], CLAUSE_UNDEF);
+            }
+        }
+        occurrences[SATSolver::watchIndex(-literal)].clear();
+    }
+
+    return !empty_clause_found;
+}
+
+void SATSolver::cleanOccurrences(int literal)
+{
+    std::vector<ClauseRef> &occurrence_list = occurrences[SATSolver::watchIndex(literal)];
+    int j = 0;
+    for (int i = 0; i < occurrence_list.size(); i++)
+    {
+        if (!arena.deleted(occurrence_list[i]))
+        {
+            occurrence_list[j++] = occurrence_list[i];
+        }
+    }
+    occurrence_list.resize(j);
+}
+
+bool SATSolver::resolve(ClauseRef positive_ref, ClauseRef negative_ref, int variable)
+{
+    Clause &positive = arena[positive_ref];
+    Clause &negative = arena[negative_ref];
+    int start = resolvents.size();
+    for (int i = 0; i < positive.size(); i++)
+    {
+        if (positive[i] != variable)
+        {
+            literal_marks[SATSolver::watchIndex(positive[i])] = 1;
+            resolvents.push_back(positive[i]);
+        }
+    }
+
+    // A literal opposite to one of the positive clause makes a tautology
+    bool tautology = false;
+    for (int i = 0; i < negative.size() && !tautology; i++)
+    {
+        int literal = negative[i];
+        if (literal == -variable || literal_marks[SATSolver::watchIndex(literal)])
+        {
+            continue;
+        }
+
+        if (literal_marks[SATSolver::watchIndex(-literal)])
+        {
+            tautology = true;
+        }
+        else
+        {
+            resolvents.push_back(literal);
+        }
+    }
+
+    for (int i = 0; i < positive.size(); i++)
+    {
+        literal_marks[SATSolver::watchIndex(positive[i])] = 0;
+    }
+
+    // A tautology is dropped again
+    if (tautology)
+    {
+        resolvents.resize(start);
+        return false;
+    }
+
+    resolvents.push_back(0);
+    return true;
+}
+
+bool SATSolver::eliminateVariable(int variable, long long &effort)
+{
+    std::vector<ClauseRef> &positives = occurrences[SATSolver::watchIndex(variable)];
+    std::vector<ClauseRef> &negatives = occurrences[SATSolver::watchIndex(-variable)];
+    effort += positives.size() + negatives.size();
+    SATSolver::cleanOccurrences(variable);
+    SATSolver::cleanOccurrences(-variable);
+    if (positives.size() > options.elimination_occurrences || negatives.size() > options.elimination_occurrences)
+    {
+        return true;
+    }
+
+    // Collect the resolvents, giving up as soon as they outnumber the
+    // clauses they replace or one of them is too long
+    resolvents.clear();
+    int resolvent_count = 0;
+    int clause_limit = positives.size() + negatives.size();
+    for (ClauseRef positive_ref : positives)
+    {
+        for (ClauseRef negative_ref : negatives)
+        {
+            effort += arena[positive_ref].size() + arena[negative_ref].size();
+            int start = resolvents.size();
+            if (!SATSolver::resolve(positive_ref, negative_ref, variable))
+            {
+                continue;
+            }
+
+            if (++resolvent_count > clause_limit || resolvents.size() - start - 1 > options.elimination_clause_size)
+            {
+                return true;
+            }
+        }
+    }
+
+    // Save the clauses of both literals, each made true only when one of
+    // its clauses is falsified; keeping both lets the clauses come back if
+    // the variable is used again
+    for (int literal : {-variable, variable})
+    {
+        for (ClauseRef clause_ref : literal > 0 ? positives : negatives)
+        {
+            Clause &clause = arena[clause_ref];
+            extension_stack.push_back(literal);
+            for (int i = 0; i < clause.size(); i++)
+            {
+                if (clause[i] != literal)
+                {
+                    extension_stack.push_back(clause[i]);
+                }
+            }
+            extension_stack.push_back(clause.size());
+        }
+    }
+
+    for (ClauseRef clause_ref : positives)
+    {
+        arena.free(clause_ref);
+    }
+    for (ClauseRef clause_ref : negatives)
+    {
+        arena.free(clause_ref);
+    }
+    statistics.eliminated_clauses += clause_limit;
+    statistics.eliminated_variables++;
+    eliminated[variable] = 1;
+    eliminated_count++;
+    positives.clear();
+    negatives.clear();
+
+    // Replace the removed clauses with the resolvents
+    int start = 0;
+    for (int i = 0; i < resolvents.size(); i++)
+    {
+        if (resolvents[i] != 0)
+        {
+            continue;
+        }
+
+        // A unit resolvent may contradict one found just before
+        int size = i - start;
+        statistics.resolvents++;
+        int value = size == 0 ? 0 : SATSolver::literalValue(resolvents[start]);
+        if (size <= 1 && value == 0)
+        {
+            empty_clause_found = true;
+            return false;
+        }
+        else if (size == 1)
+        {
+            if (value == -1)
+            {
+                SATSolver::assignLiteral(resolvents[start], CLAUSE_UNDEF);
+            }
+        }
+        else
+        {
+            ClauseRef clause_ref = arena.allocate(&resolvents[start], size, false);
+            clauses.push_back(clause_ref);
+            for (int k = start; k < i; k++)
+            {
+                occurrences[SATSolver::watchIndex(resolvents[k])].push_back(clause_ref);
+            }
+        }
+        start = i + 1;
+    }
+
+    return true;
+}
+
+void SATSolver::removeSatisfied(std::vector<ClauseRef> &clause_refs)
+{
+    int j = 0;
+    for (int i = 0; i < clause_refs.size(); i++)
+    {
+        Clause &clause = arena[clause_refs[i]];
+
+        // Clauses already freed through another list are only dropped
+        if (arena.deleted(clause_refs[i]))
+        {
+            continue;
+        }
+
+        bool satisfied = false;
+        for (int k = 0; k < clause.size(); k++)
+        {
+            if (SATSolver::literalValue(clause[k]) == 1)
+            {
+                satisfied = true;
+                break;
+            }
+        }
+
+        if (satisfied)
+        {
+            arena.free(clause_refs[i]);
+        }
+        else
+        {
+            clause_refs[j++] = clause_refs[i];
+        }
+    }
+    clause_refs.resize(j);
+}
+
+void SATSolver::purgeWatches()
+{
+    for (int literal = -variable_count; literal <= variable_count; literal++)
+    {
+        if (literal == 0)
+        {
+            continue;
+        }
+
+        // A binary clause is satisfied at decision level 0 once either literal is
+        bool literal_fixed = levels[abs(literal)] == 0 && SATSolver::literalValue(literal) == 1;
+        std::vector<Watcher> &watch_list = watches[SATSolver::watchIndex(literal)];
+        int j = 0;
+        for (int i = 0; i < watch_list.size(); i++)
+        {
+            Watcher watcher = watch_list[i];
+            bool removed;
+            if (watcher.binary())
+            {
+                int blocker = watcher.blocker;
+                removed = literal_fixed || (levels[abs(blocker)] == 0 && SATSolver::literalValue(blocker) == 1);
+            }
+            else
+            {
+                removed = arena.deleted(watcher.clause_ref);
+            }
+
+            if (!removed)
+            {
+                watch_list[j++] = watcher;
+            }
+        }
+        watch_list.resize(j);
+
+        std::vector<TernaryWatcher> &ternary_list = ternary_watches[SATSolver::watchIndex(literal)];
+        j = 0;
+        for (int i = 0; i < ternary_list.size(); i++)
+        {
+            if (!arena.deleted(ternary_list[i].clause_ref))
+            {
+                ternary_list[j++] = ternary_list[i];
+            }
+        }
+        ternary_list.resize(j);
+    }
+}
+
+void SATSolver::simplifyDatabase()
+{
+    // Only new decision level 0 assignments can satisfy more clauses
+    if (SATSolver::decisionLevel() != 0 || trail.size() == simplified_trail_size)
+    {
+        return;
+    }
+
+    SATSolver::removeSatisfied(clauses);
+    attached_clause_count = clauses.size();
+    for (auto &tier_learnts : learnts)
+    {
+        SATSolver::removeSatisfied(tier_learnts);
+    }
+    SATSolver::purgeWatches();
+
+    // Decision level 0 assignments are never analyzed, so they need no reasons
+    for (int literal : trail)
+    {
+        reasons[abs(literal)] = CLAUSE_UNDEF;
+    }
+
+    simplified_trail_size = trail.size();
+
+    // Compact the arena once a fifth of it is taken by freed clauses
+    if (arena.wasted() > arena.size() / 5)
+    {
+        SATSolver::garbageCollect();
+    }
+}
+
+void SATSolver::garbageCollect()
+{
+    ClauseArena compacted;
+    compacted.reserve(arena.size() - arena.wasted());
+
+    // Every reference is rewritten; clauses move in the order they are first met
+    for (auto &watch_list : watches)
+    {
+        for (auto &watcher : watch_list)
+        {
+            if (!watcher.binary())
+            {
+                arena.relocate(watcher.clause_ref, compacted);
+            }
+        }
+    }
+    for (auto &watch_list : ternary_watches)
+    {
+        for (auto &watcher : watch_list)
+        {
+            arena.relocate(watcher.clause_ref, compacted);
+        }
+    }
+
+    for (int literal : trail)
+    {
+        ClauseRef &reason = reasons[abs(literal)];
+        if (reason != CLAUSE_UNDEF && !isBinaryReason(reason))
+        {
+            arena.relocate(reason, compacted);
+        }
+    }
+
+    // Clauses freed by inprocessing may still be listed; they are dropped
+    // rather than copied, so that the new arena wastes nothing on them.
+    // The number of live clauses among the first attached_count is returned
+    auto relocateLive = [&](std::vector<ClauseRef> &clause_refs, int attached_count)
+    {
+        int j = 0;
+        int attached = 0;
+        for (int i = 0; i < clause_refs.size(); i++)
+        {
+            if (arena.deleted(clause_refs[i]))
+            {
+                continue;
+            }
+
+            arena.relocate(clause_refs[i], compacted);
+            clause_refs[j++] = clause_refs[i];
+            attached += i < attached_count;
+        }
+        clause_refs.resize(j);
+        return attached;
+    };
+    for (auto &tier_learnts : learnts)
+    {
+        relocateLive(tier_learnts, 0);
+    }
+    attached_clause_count = relocateLive(clauses, attached_clause_count);
+
+    arena.swap(compacted);
+}
+
+ClauseRef SATSolver::unitPropagation()
+{
+    while (propagation_head < trail.size())
+    {
+        // The literal on the trail is true, so its negation has become false
+        int false_literal = -trail[propagation_head++];
+        statistics.propagations++;
+
+        // A ternary clause is satisfied, unit or conflicting depending on
+        // the two other literals kept in its watcher
+        for (TernaryWatcher &watcher : ternary_watches[SATSolver::watchIndex(false_literal)])
+        {
+            int first_value = SATSolver::literalValue(watcher.first);
+            int second_value = SATSolver::literalValue(watcher.second);
+            if (first_value == 1 || second_value == 1 || (first_value == -1 && second_value == -1))
+            {
+                continue;
+            }
+
+            if (first_value == 0 && second_value == 0)
+            {
+                propagation_head = trail.size();
+                return watcher.clause_ref;
+            }
+
+            SATSolver::assignLiteral(first_value == 0 ? watcher.second : watcher.first, watcher.clause_ref);
+        }
+
+        std::vector<Watcher> &watch_list = watches[SATSolver::watchIndex(false_literal)];
+
+        // Watchers that stay on the false literal are compacted to the front
+        int i = 0, j = 0;
+        while (i < watch_list.size())
+        {
+            Watcher watcher = watch_list[i++];
+
+            // If the blocker is true, the clause is satisfied
+            int blocker_value = SATSolver::literalValue(watcher.blocker);
+            if (blocker_value == 1)
+            {
+                watch_list[j++] = watcher;
+                continue;
+            }
+
+            // A binary clause is unit or conflicting as soon as its blocker is not true
+            if (watcher.binary())
+            {
+                watch_list[j++] = watcher;
+                if (blocker_value == 0)
+                {
+                    binary_conflict[0] = false_literal;
+                    binary_conflict[1] = watcher.blocker;
+                    while (i < watch_list.size())
+                    {
+                        watch_list[j++] = watch_list[i++];
+                    }
+                    watch_list.resize(j);
+                    propagation_head = trail.size();
+                    return BINARY_REASON;
+                }
+
+                SATSolver::assignLiteral(watcher.blocker, binaryReason(false_literal));
+                continue;
+            }
+
+            ClauseRef clause_ref = watcher.clause_ref;
+            Clause &clause = arena[clause_ref];
+            bool new_watch_found = false;
+            int first;
+            if (!arena.inBase(clause_ref))
+            {
+                // Make sure the false literal is the second watched literal
+                if (clause[0] == false_literal)
+                {
+                    std::swap(clause[0], clause[1]);
+                }
+
+                // If the other watched literal is true, it becomes the blocker
+                first = clause[0];
+                if (first != watcher.blocker && SATSolver::literalValue(first) == 1)
+                {
+                    watch_list[j++] = {first, clause_ref};
+                    continue;
+                }
+
+                // Look for a literal that is not false to watch instead
+                for (int k = 2; k < clause.size(); k++)
+                {
+                    if (SATSolver::literalValue(clause[k]) != 0)
+                    {
+                        std::swap(clause[1], clause[k]);
+                        watches[SATSolver::watchIndex(clause[1])].push_back({first, clause_ref});
+                        new_watch_found = true;
+                        break;
+                    }
+                }
+            }
+            else
+            {
+                // A base clause is only read, so the positions of its
+                // watched literals move instead of the literals
+                BaseClauseState &state = arena.baseState(clause_ref);
+                if (clause[state.first_watch] == false_literal)
+                {
+                    uint32_t position = state.first_watch;
+                    state.first_watch = state.second_watch;
+                    state.second_watch = position;
+                }
+
+                first = clause[state.first_watch];
+                if (first != watcher.blocker && SATSolver::literalValue(first) == 1)
+                {
+                    watch_list[j++] = {first, clause_ref};
+                    continue;
+                }
+
+                for (int k = 0; k < clause.size(); k++)
+                {
+                    if (k != state.first_watch && k != state.second_watch && SATSolver::literalValue(clause[k]) != 0)
+                    {
+                        state.second_watch = k;
+                        watches[SATSolver::watchIndex(clause[k])].push_back({first, clause_ref});
+                        new_watch_found = true;
+                        break;
+                    }
+                }
+            }
+
+            if (new_watch_found)
+            {
+                continue;
+            }
+
+            // The clause is unit or conflicting, so it keeps its watches
+            watch_list[j++] = {first, clause_ref};
+
+            // If the other watched literal is false, the clause is conflicting
+            if (SATSolver::literalValue(first) == 0)
+            {
+                while (i < watch_list.size())
+                {
+                    watch_list[j++] = watch_list[i++];
+                }
+                watch_list.resize(j);
+                propagation_head = trail.size();
+                return clause_ref;
+            }
+
+            // Otherwise, the clause is unit, so assign the other watched literal
+            SATSolver::assignLiteral(first, clause_ref);
+        }
+        watch_list.resize(j);
+    }
+
+    return CLAUSE_UNDEF;
+}
+
+int SATSolver::chooseLiteral()
+{
+    // Basic strategy
+    if (strategy == 0)
+    {
+        // Choose the first unassigned variable
+        for (int variable = 1; variable <= variable_count; variable++)
+        {
+            if (values[variable] == -1 && !eliminated[variable])
+            {
+                return saved_phases[variable] ? variable : -variable;
+            }
+        }
+    }
+    // VSIDS
+    else if (strategy == 1)
+    {
+        // Choose the unassigned variable with the highest score, dropping
+        // the assigned and eliminated variables found on top of the heap
+        while (!order_heap.empty())
+        {
+            int variable = order_heap.removeMax();
+            if (values[variable] == -1 && !eliminated[variable])
+            {
+                int phase = saved_phases[variable];
+                if (options.target_phases && target_phases[variable] != -1)
+                {
+                    phase = target_phases[variable];
+                }
+                return phase ? variable : -variable;
+            }
+        }
+    }
+
+    return 0;
+}
+
+void SATSolver::updateTargetPhases(int consistent_size)
+{
+    if (consistent_size > target_trail_size)
+    {
+        for (int i = 0; i < consistent_size; i++)
+        {
+            target_phases[abs(trail[i])] = trail[i] > 0;
+        }
+        target_trail_size = consistent_size;
+    }
+
+    if (consistent_size > best_trail_size)
+    {
+        for (int i = 0; i < consistent_size; i++)
+        {
+            best_phases[abs(trail[i])] = trail[i] > 0;
+        }
+        best_trail_size = consistent_size;
+    }
+}
+
+void SATSolver::rephase()
+{
+    // Best phases alternate with the other kinds
+    const char schedule[] = {'B', 'O', 'B', 'I', 'B', 'W', 'B', 'R'};
+    char kind = schedule[statistics.rephases % 8];
+    statistics.rephases++;
+
+    // Backtrack first so that phase saving does not undo the new phases
+    SATSolver::backtrack(0);
+
+    for (int variable = 1; variable <= variable_count; variable++)
+    {
+        if (kind == 'B' && best_phases[variable] != -1)
+        {
+            saved_phases[variable] = best_phases[variable];
+        }
+        else if (kind == 'O')
+        {
+            saved_phases[variable] = options.initial_phase;
+        }
+        else if (kind == 'I')
+        {
+            saved_phases[variable] = !options.initial_phase;
+        }
+        else if (kind == 'R')
+        {
+            saved_phases[variable] = random_generator() & 1;
+        }
+    }
+
+    if (kind == 'W')
+    {
+        SATSolver::walkPhases();
+    }
+
+    // Start looking for the longest trail under the new phases
+    if (kind == 'B')
+    {
+        best_trail_size = 0;
+    }
+    target_trail_size = 0;
+    std::fill(target_phases.begin(), target_phases.end(), -1);
+}
+
+void SATSolver::walkPhases()
+{
+    // Walk on the original clauses simplified by decision level 0
+    Walker walker(variable_count, random_generator());
+    std::vector<int> literals;
+    for (ClauseRef clause_ref : clauses)
+    {
+        Clause &clause = arena[clause_ref];
+        if (arena.deleted(clause_ref))
+        {
+            continue;
+        }
+
+        literals.clear();
+        bool satisfied = false;
+        for (int i = 0; i < clause.size() && !satisfied; i++)
+        {
+            int value = SATSolver::literalValue(clause[i]);
+            if (value == 1)
+            {
+                satisfied = true;
+            }
+            else if (value == -1)
+            {
+                literals.push_back(clause[i]);
+            }
+        }
+
+        if (!satisfied && !literals.empty())
+        {
+            walker.addClause(literals.data(), literals.size());
+        }
+    }
+
+    // Add every original binary clause once, from the watch list of its smaller literal
+    for (int literal = -variable_count; literal <= variable_count; literal++)
+    {
+        if (literal == 0 || SATSolver::literalValue(literal) != -1)
+        {
+            continue;
+        }
+
+        for (Watcher watcher : watches[SATSolver::watchIndex(literal)])
+        {
+            if (watcher.clause_ref != BINARY_ORIGINAL || SATSolver::literalValue(watcher.blocker) == 1)
+            {
+                continue;
+            }
+
+            if (SATSolver::literalValue(watcher.blocker) == 0)
+            {
+                walker.addClause(&literal, 1);
+            }
+            else if (literal < watcher.blocker)
+            {
+                int binary[2] = {literal, watcher.blocker};
+                walker.addClause(binary, 2);
+            }
+        }
+    }
+
+    // Under assumptions, the model looked for is one of the assumptions
+    for (int assumption : assumptions)
+    {
+        if (SATSolver::literalValue(assumption) == -1)
+        {
+            walker.addClause(&assumption, 1);
+        }
+    }
+
+    walker.walk(saved_phases, options.walk_flips);
+    statistics.walk_flips += walker.getFlips();
+}
+
+void SATSolver::bumpVariable(int variable)
+{
+    activity[variable] += activity_increment;
+
+    // Rescale every activity before it overflows; the order is unchanged
+    if (activity[variable] > 1e100)
+    {
+        for (int i = 1; i <= variable_count; i++)
+        {
+            activity[i] *= 1e-100;
+        }
+        activity_increment *= 1e-100;
+    }
+
+    order_heap.increase(variable);
+}
+
+void SATSolver::decayActivities()
+{
+    activity_increment /= activity_decay;
+}
+
+uint32_t SATSolver::abstractLevel(int variable)
+{
+    return 1u << (levels[variable] & 31);
+}
+
+bool SATSolver::literalRedundant(int literal, uint32_t abstract_levels)
+{
+    analyze_stack.clear();
+    analyze_stack.push_back(literal);
+    int toclear_start = analyze_toclear.size();
+
+    while (!analyze_stack.empty())
+    {
+        int current = analyze_stack.back();
+        analyze_stack.pop_back();
+
+        // The first literal of the reason is the current literal, negated
+        int reason_size;
+        int *reason = SATSolver::reasonLiterals(reasons[abs(current)], -current, reason_size);
+        for (int i = 1; i < reason_size; i++)
+        {
+            int antecedent = reason[i];
+            int variable = abs(antecedent);
+
+            // Literals in the learned clause or already shown redundant are fine
+            if (seen[variable] || levels[variable] == 0)
+            {
+                continue;
+            }
+
+            // Implied literals on a level of the learned clause may be redundant too
+            if (reasons[variable] != CLAUSE_UNDEF && (SATSolver::abstractLevel(variable) & abstract_levels) != 0)
+            {
+                seen[variable] = 1;
+                analyze_stack.push_back(antecedent);
+                analyze_toclear.push_back(antecedent);
+            }
+            else
+            {
+                // Otherwise, undo the marks made while checking this literal
+                for (int j = toclear_start; j < analyze_toclear.size(); j++)
+                {
+                    seen[abs(analyze_toclear[j])] = 0;
+                }
+                analyze_toclear.resize(toclear_start);
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+void SATSolver::minimizeLearnedClause()
+{
+    analyze_toclear.assign(learned_clause.begin(), learned_clause.end());
+
+    // A literal can only be implied by literals from the levels of the clause
+    uint32_t abstract_levels = 0;
+    for (int i = 1; i < learned_clause.size(); i++)
+    {
+        abstract_levels |= SATSolver::abstractLevel(abs(learned_clause[i]));
+    }
+
+    int j = 1;
+    for (int i = 1; i < learned_clause.size(); i++)
+    {
+        int literal = learned_clause[i];
+        if (reasons[abs(literal)] == CLAUSE_UNDEF || !SATSolver::literalRedundant(literal, abstract_levels))
+        {
+            learned_clause[j++] = literal;
+        }
+    }
+    statistics.minimized_literals += learned_clause.size() - j;
+    learned_clause.resize(j);
+
+    for (int literal : analyze_toclear)
+    {
+        seen[abs(literal)] = 0;
+    }
+}
+
+void SATSolver::binaryMinimizeLearnedClause()
+{
+    for (int i = 1; i < learned_clause.size(); i++)
+    {
+        seen[abs(learned_clause[i])] = 1;
+    }
+
+    // A true literal whose negation is in the clause and which forms a binary
+    // clause with the asserting literal resolves that negation away
+    int asserting_literal = learned_clause[0];
+    int removable_count = 0;
+    for (Watcher watcher : watches[SATSolver::watchIndex(asserting_literal)])
+    {
+        if (!watcher.binary())
+        {
+            continue;
+        }
+
+        int other = watcher.blocker;
+        if (seen[abs(other)] == 1 && SATSolver::literalValue(other) == 1)
+        {
+            seen[abs(other)] = 2;
+            removable_count++;
+        }
+    }
+
+    int j = 1;
+    for (int i = 1; i < learned_clause.size(); i++)
+    {
+        int literal = learned_clause[i];
+        if (seen[abs(literal)] != 2)
+        {
+            learned_clause[j++] = literal;
+        }
+        seen[abs(literal)] = 0;
+    }
+    learned_clause.resize(j);
+    statistics.binary_minimized_literals += removable_count;
+}
+
+int SATSolver::computeLBD(int *literals, int size)
+{
+    lbd_stamp++;
+    int lbd = 0;
+    for (int i = 0; i < size; i++)
+    {
+        int level = levels[abs(literals[i])];
+        if (level_stamps[level] != lbd_stamp)
+        {
+            level_stamps[level] = lbd_stamp;
+            lbd++;
+        }
+    }
+    return lbd;
+}
+
+void SATSolver::bumpClause(ClauseRef clause_ref)
+{
+    Clause &clause = arena[clause_ref];
+    clause.activity += clause_activity_increment;
+
+    // Rescale every learned clause activity before the float overflows,
+    // skipping stale entries so that no clause is scaled twice
+    if (clause.activity > 1e20)
+    {
+        for (int tier = ClauseTier::core; tier <= ClauseTier::local; tier++)
+        {
+            for (ClauseRef learned_ref : learnts[tier])
+            {
+                if (arena[learned_ref].tier == tier)
+                {
+                    arena[learned_ref].activity *= 1e-20;
+                }
+            }
+        }
+        clause_activity_increment *= 1e-20;
+    }
+}
+
+void SATSolver::updateLearnedClause(ClauseRef clause_ref)
+{
+    Clause &clause = arena[clause_ref];
+    clause.used = 1;
+    SATSolver::bumpClause(clause_ref);
+
+    // Count each imported clause once, at its first conflict
+    if (clause.imported)
+    {
+        clause.imported = 0;
+        statistics.imported_clauses_used++;
+    }
+
+    // Core clauses are kept forever, so their LBD no longer matters
+    if (clause.tier == ClauseTier::core)
+    {
+        return;
+    }
+
+    int lbd = SATSolver::computeLBD(clause.literals(), clause.size());
+    if (lbd >= clause.lbd)
+    {
+        return;
+    }
+    clause.lbd = lbd;
+
+    if (lbd <= options.core_lbd)
+    {
+        clause.tier = ClauseTier::core;
+        learnts[ClauseTier::core].push_back(clause_ref);
+        statistics.promoted_clauses++;
+    }
+    else if (lbd <= options.tier2_lbd && clause.tier == ClauseTier::local)
+    {
+        clause.tier = ClauseTier::tier2;
+        learnts[ClauseTier::tier2].push_back(clause_ref);
+        statistics.promoted_clauses++;
+    }
+}
+
+bool SATSolver::locked(ClauseRef clause_ref)
+{
+    Clause &clause = arena[clause_ref];
+    int implied_candidates = clause.size() == 3 ? 3 : 1;
+    for (int i = 0; i < implied_candidates; i++)
+    {
+        if (reasons[abs(clause[i])] == clause_ref && SATSolver::literalValue(clause[i]) == 1)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void SATSolver::updateRestartAverages(int lbd)
+{
+    conflicts_since_restart++;
+    lbd_fast_average.update(lbd);
+    lbd_slow_average.update(lbd);
+
+    // A trail much longer than usual suggests the solver is close to a model,
+    // so postpone the next restart
+    if (options.restart_policy == restart_ema && statistics.conflicts > options.restart_block_conflicts && trail.size() > options.restart_block_margin * trail_average.value)
+    {
+        if (conflicts_since_restart >= options.restart_min_conflicts)
+        {
+            statistics.blocked_restarts++;
+        }
+        conflicts_since_restart = 0;
+    }
+    trail_average.update(trail.size());
+}
+
+bool SATSolver::restartDue()
+{
+    if (options.restart_policy == restart_luby)
+    {
+        return conflicts_since_restart >= luby(2, statistics.restarts) * options.luby_unit;
+    }
+    else if (options.restart_policy == restart_ema)
+    {
+        return conflicts_since_restart >= options.restart_min_conflicts && lbd_fast_average.value > options.restart_margin * lbd_slow_average.value;
+    }
+
+    return false;
+}
+
+int SATSolver::reusedTrailLevel()
+{
+    if (strategy != 1)
+    {
+        return 0;
+    }
+
+    // Drop the assigned variables from the top of the heap to find the next decision
+    while (!order_heap.empty() && values[order_heap.top()] != -1)
+    {
+        order_heap.removeMax();
+    }
+
+    if (order_heap.empty())
+    {
+        return 0;
+    }
+
+    // The levels up to the first decision less active than the next one
+    // would be decided again in the same order after a full restart
+    double next_activity = activity[order_heap.top()];
+    for (int level = 0; level < SATSolver::decisionLevel(); level++)
+    {
+        int decision = abs(trail[trail_lim[level]]);
+        if (activity[decision] < next_activity)
+        {
+            return level;
+        }
+    }
+
+    return SATSolver::decisionLevel();
+}
+
+void SATSolver::restart()
+{
+    int level = options.trail_reuse ? SATSolver::reusedTrailLevel() : 0;
+    statistics.restarts++;
+    statistics.reused_levels += level;
+    conflicts_since_restart = 0;
+    SATSolver::backtrack(level);
+}
+
+void SATSolver::reduceDatabase()
+{
+    statistics.reductions++;
+
+    // Tier2 clauses that did not take part in a conflict since the last
+    // reduction move to the local tier
+    std::vector<ClauseRef> &tier2_learnts = learnts[ClauseTier::tier2];
+    int j = 0;
+    for (int i = 0; i < tier2_learnts.size(); i++)
+    {
+        Clause &clause = arena[tier2_learnts[i]];
+        if (clause.deleted || clause.tier != ClauseTier::tier2)
+        {
+            continue;
+        }
+
+        if (clause.used)
+        {
+            clause.used = 0;
+            tier2_learnts[j++] = tier2_learnts[i];
+        }
+        else
+        {
+            clause.tier = ClauseTier::local;
+            learnts[ClauseTier::local].push_back(tier2_learnts[i]);
+        }
+    }
+    tier2_learnts.resize(j);
+
+    // Drop stale entries from the local clauses; a clause that left the
+    // local tier and came back is listed twice, so remove duplicates too
+    std::vector<ClauseRef> &local_learnts = learnts[ClauseTier::local];
+    j = 0;
+    for (int i = 0; i < local_learnts.size(); i++)
+    {
+        Clause &clause = arena[local_learnts[i]];
+        if (!clause.deleted && clause.tier == ClauseTier::local)
+        {
+            local_learnts[j++] = local_learnts[i];
+        }
+    }
+    local_learnts.resize(j);
+    std::sort(local_learnts.begin(), local_learnts.end());
+    local_learnts.erase(std::unique(local_learnts.begin(), local_learnts.end()), local_learnts.end());
+
+    // Sort the local clauses worst first
+    std::sort(local_learnts.begin(), local_learnts.end(), [this](ClauseRef a, ClauseRef b)
+              { return arena[a].lbd > arena[b].lbd || (arena[a].lbd == arena[b].lbd && arena[a].activity < arena[b].activity); });
+
+    // Delete the worse half, except for the clauses that are reasons
+    int delete_count = local_learnts.size() / 2;
+    j = 0;
+    for (int i = 0; i < local_learnts.size(); i++)
+    {
+        ClauseRef clause_ref = local_learnts[i];
+        if (i < delete_count && !SATSolver::locked(clause_ref))
+        {
+            arena.free(clause_ref);
+            statistics.deleted_clauses++;
+        }
+        else
+        {
+            arena[clause_ref].used = 0;
+            local_learnts[j++] = clause_ref;
+        }
+    }
+    local_learnts.resize(j);
+
+    SATSolver::purgeWatches();
+
+    // Compact the arena once a fifth of it is taken by freed clauses
+    if (arena.wasted() > arena.size() / 5)
+    {
+        SATSolver::garbageCollect();
+    }
+}
+
+int SATSolver::analyzeConflict(ClauseRef conflict_ref)
+{
+    // The first position is kept for the asserting literal
+    learned_clause.clear();
+    learned_clause.push_back(0);
+
+    // Number of literals of the current decision level still to be resolved
+    int path_count = 0;
+
+    // Literal resolved on, 0 while the conflict clause itself is visited
+    int resolved_literal = 0;
+
+    int trail_index = trail.size() - 1;
+    ClauseRef reason_ref = conflict_ref;
+
+    do
+    {
+        if (!isBinaryReason(reason_ref) && arena[reason_ref].learnt)
+        {
+            SATSolver::updateLearnedClause(reason_ref);
+        }
+
+        int reason_size;
+        int *reason = SATSolver::reasonLiterals(reason_ref, resolved_literal, reason_size);
+
+        // The first literal of a reason is the literal it implied, skip it
+        for (int i = resolved_literal == 0 ? 0 : 1; i < reason_size; i++)
+        {
+            int literal = reason[i];
+            int variable = abs(literal);
+
+            // Decision level 0 literals are false in every model, drop them
+            if (seen[variable] || levels[variable] == 0)
+            {
+                continue;
+            }
+
+            seen[variable] = 1;
+            SATSolver::bumpVariable(variable);
+
+            if (levels[variable] == SATSolver::decisionLevel())
+            {
+                path_count++;
+            }
+            else
+            {
+                learned_clause.push_back(literal);
+            }
+        }
+
+        // Resolve next on the latest assigned literal seen on the trail
+        while (!seen[abs(trail[trail_index])])
+        {
+            trail_index--;
+        }
+        resolved_literal = trail[trail_index--];
+        reason_ref = reasons[abs(resolved_literal)];
+        seen[abs(resolved_literal)] = 0;
+        path_count--;
+    } while (path_count > 0);
+
+    // The last literal resolved on is the first UIP, its negation is asserted
+    learned_clause[0] = -resolved_literal;
+
+    // Shorten the clause while the seen marks still describe it
+    if (options.minimization)
+    {
+        SATSolver::minimizeLearnedClause();
+    }
+    else
+    {
+        for (int i = 1; i < learned_clause.size(); i++)
+        {
+            seen[abs(learned_clause[i])] = 0;
+        }
+    }
+
+    if (options.binary_minimization && learned_clause.size() <= options.binary_minimization_size)
+    {
+        SATSolver::binaryMinimizeLearnedClause();
+    }
+
+    statistics.learned_literals += learned_clause.size();
+    int lbd = SATSolver::computeLBD(learned_clause.data(), learned_clause.size());
+    SATSolver::updateRestartAverages(lbd);
+    SATSolver::updateTargetPhases(trail_lim.back());
+    SATSolver::decayActivities();
+    clause_activity_increment /= options.clause_decay;
+
+    // Watch the asserting literal and the literal with the highest decision level,
+    // which is also the level to backtrack to
+    int backtrack_level = 0;
+    for (int i = 1; i < learned_clause.size(); i++)
+    {
+        if (levels[abs(learned_clause[i])] > backtrack_level)
+        {
+            backtrack_level = levels[abs(learned_clause[i])];
+            std::swap(learned_clause[1], learned_clause[i]);
+        }
+    }
+
+    if (exchange != nullptr)
+    {
+        SATSolver::exportClause(learned_clause.data(), learned_clause.size(), lbd);
+    }
+    if (learn_callback != nullptr && learned_clause.size() <= learn_max_size)
+    {
+        learned_clause.push_back(0);
+        learn_callback(learn_data, learned_clause.data());
+        learned_clause.pop_back();
+    }
+
+    SATSolver::backtrack(backtrack_level);
+
+    // A learned unit clause is a decision level 0 assignment and is not stored
+    if (learned_clause.size() == 1)
+    {
+        SATSolver::assignLiteral(learned_clause[0], CLAUSE_UNDEF);
+        return backtrack_level;
+    }
+
+    // A learned binary clause is only stored in the watch lists
+    if (learned_clause.size() == 2)
+    {
+        SATSolver::watchBinaryClause(learned_clause[0], learned_clause[1], true);
+        SATSolver::assignLiteral(learned_clause[0], binaryReason(learned_clause[1]));
+        return backtrack_level;
+    }
+
+    ClauseRef learned_ref = arena.allocate(learned_clause.data(), learned_clause.size(), true);
+    Clause &learned = arena[learned_ref];
+    learned.lbd = lbd;
+    learned.tier = lbd <= options.core_lbd ? ClauseTier::core : lbd <= options.tier2_lbd ? ClauseTier::tier2 : ClauseTier::local;
+    learnts[learned.tier].push_back(learned_ref);
+    SATSolver::bumpClause(learned_ref);
+    SATSolver::watchClause(learned_ref);
+    SATSolver::assignLiteral(learned_clause[0], learned_ref);
+
+    return backtrack_level;
+}
+
+void SATSolver::backtrack(int decision_level)
 {
-    // Initialize the formula
-    this->formula = formula;
+    // If the decision level is not below the current one, there is nothing to undo
+    if (SATSolver::decisionLevel() <= decision_level)
+    {
+        return;
+    }
 
-    // Initialize the literals
-    for (int i = 0; i < formula.size(); i++)
+    // Pop the literals assigned above the given decision level from the trail
+    int trail_start = trail_lim[decision_level];
+    for (int i = trail.size() - 1; i >= trail_start; i--)
     {
-        for (int j = 0; j < formula[i].size(); j++)
+        int variable = abs(trail[i]);
+        if (options.phase_saving)
         {
-            int literal = abs(formula[i][j]);
-            int index = SATSolver::get_literal_index(literal);
-            if (index == -1)
-            {
-                // If the literal is not in the map, add it
-                literals.push_back(Literal(literal, -1, -1));
-            }
+            saved_phases[variable] = values[variable];
         }
+        values[variable] = -1;
+        levels[variable] = -1;
+        reasons[variable] = CLAUSE_UNDEF;
+        order_heap.insert(variable);
     }
-
-    // Initialize the literal count
-    this->literal_count = literals.size();
-    this->assigned_literal_count = 0;
-
-    // Initialize the antecedent clause
-    this->antecedent_clause = -1;
-
-    // Initialize the strategy
-    this->strategy = 1;
+    trail.resize(trail_start);
+    trail_lim.resize(decision_level);
+    propagation_head = trail.size();
 }
 
-SATSolver::SATSolver(std::vector<std::vector<int>> &formula, int &strategy)
+bool SATSolver::prepareSearch()
 {
-    // Initialize the formula
-    this->formula = formula;
+    // If the formula has an empty clause, it is unsatisfied
+    if (empty_clause_found)
+    {
+        return false;
+    }
+
+    // Simplify the formula once, before any clause is watched
+    if ((options.substitution || options.subsumption || options.elimination) && !prepared)
+    {
+        SATSolver::detachClauses();
+        if (options.substitution)
+        {
+            SATSolver::substituteEquivalentLiterals();
+        }
+        if (options.subsumption && !empty_clause_found)
+        {
+            SATSolver::subsumeClauses();
+        }
+        if (options.elimination && !empty_clause_found)
+        {
+            SATSolver::eliminateVariables();
+        }
+        SATSolver::reattachClauses();
+        if (empty_clause_found)
+        {
+            return false;
+        }
+    }
 
-    // Initialize the literals
-    for (int i = 0; i < formula.size(); i++)
+    SATSolver::attachClauses();
+
+    // Assign the literals of unit clauses at decision level 0
+    for (ClauseRef clause_ref : clauses)
     {
-        for (int j = 0; j < formula[i].size(); j++)
+        Clause &clause = arena[clause_ref];
+        if (clause.size() == 1)
         {
-            int literal = formula[i][j];
-            int index = SATSolver::get_literal_index(literal);
-            if (index == -1)
+            int value = SATSolver::literalValue(clause[0]);
+
+            // If two unit clauses contradict each other, the formula is unsatisfied
+            if (value == 0)
+            {
+                empty_clause_found = true;
+                return false;
+            }
+            else if (value == -1)
             {
-                // If the literal is not in the map, add it
-                literals.push_back(Literal(abs(literal), -1, -1));
+                SATSolver::assignLiteral(clause[0], clause_ref);
             }
         }
     }
 
-    // Initialize the literal count
-    this->literal_count = literals.size();
-    this->assigned_literal_count = 0;
+    // If there is a conflict at decision level 0, the formula is unsatisfied
+    if (SATSolver::unitPropagation() != CLAUSE_UNDEF)
+    {
+        empty_clause_found = true;
+        return false;
+    }
 
-    // Initialize the antecedent clause
-    this->antecedent_clause = -1;
+    // The schedules and phases carry over from one search to the next
+    if (prepared)
+    {
+        return true;
+    }
+    prepared = true;
 
-    // Initialize the strategy
-    this->strategy = strategy;
+    next_reduce = options.reduce_interval;
+    lbd_fast_average.alpha = options.restart_fast_alpha;
+    lbd_slow_average.alpha = options.restart_slow_alpha;
+    trail_average.alpha = options.restart_slow_alpha * 100;
+    conflicts_since_restart = 0;
+
+    // Every variable starts with the initial phase and no target or best phase
+    saved_phases.assign(variable_count + 1, options.initial_phase);
+    target_phases.assign(variable_count + 1, -1);
+    best_phases.assign(variable_count + 1, -1);
+    target_trail_size = 0;
+    best_trail_size = 0;
+    next_rephase = options.rephase_interval;
+    next_subsumption = options.subsumption_interval;
+    next_probe = options.probing_interval;
+    probe_variable = 1;
+    probed_search_propagations = 0;
+    next_vivify = options.vivification_interval;
+    vivified_search_propagations = 0;
+    random_generator.seed(options.seed);
+
+    return true;
 }
 
-int SATSolver::get_literal_index(int &literal)
+SAT SATSolver::search()
 {
-    for (int i = 0; i < literals.size(); i++)
+    // A new search starts over from decision level 0, keeping what the
+    // previous ones learned
+    SATSolver::backtrack(0);
+    failed_assumption = 0;
+    if (!SATSolver::prepareSearch())
     {
-        if (literals[i].literal == abs(literal))
-        {
-            return i;
-        }
+        return unsatisfied;
     }
-    return -1;
-}
 
-int SATSolver::unitPropagation(int &decision_level)
-{
-    bool unit_clause_found = true;
+    ClauseRef conflict_clause;
 
-    // Unit propagation
-    while (unit_clause_found)
+    // Assign literals until every variable left is assigned or a conflict
+    // at decision level 0 is found
+    while (trail.size() + eliminated_count != variable_count)
     {
-        unit_clause_found = false;
-
-        for (int i = 0; i < formula.size() && !unit_clause_found; i++)
+        // Give up as soon as another thread asks for it or the conflict
+        // budget is spent
+        if ((terminate_flag != nullptr && terminate_flag->load(std::memory_order_relaxed)) || (terminate_callback != nullptr && terminate_callback(terminate_data)) || statistics.conflicts >= conflict_limit)
         {
-            int unassigned_count = 0;
-            int unassigned_literal;
-            int unassigned_literal_index;
+            return normal;
+        }
 
-            bool clause_satisfied = false;
+        // Restart when the policy asks for it
+        bool restarted = SATSolver::restartDue();
+        if (restarted)
+        {
+            SATSolver::restart();
+        }
 
-            for (int j = 0; j < formula[i].size(); j++)
+        // Add the clauses of the other solvers at restarts and whenever the
+        // search is back at decision level 0
+        if (exchange != nullptr && (restarted || SATSolver::decisionLevel() == 0) && exchange->pending(exchange_worker))
+        {
+            if (!SATSolver::importClauses())
             {
-                int literal = formula[i][j];
-                int index = SATSolver::get_literal_index(literal);
-                // If the literal is unassigned, increment the unassigned count
-                if (literals[index].value == -1)
-                {
-                    unassigned_count++;
-                    unassigned_literal = literal;
-                    unassigned_literal_index = index;
-                }
-                // If the literal is assigned and satisfied, skip the clause
-                else if ((literals[index].value == 1 && literal < 0) || (literals[index].value == 0 && literal > 0))
-                {
-                    continue;
-                }
-                // If the literal is assigned and unsatisfied, the clause is satisfied
-                else
-                {
-                    clause_satisfied = true;
-                    break;
-                }
+                return unsatisfied;
             }
+            continue;
+        }
+
+        // Reset the saved phases periodically
+        if (statistics.conflicts >= next_rephase)
+        {
+            SATSolver::rephase();
+            next_rephase = statistics.conflicts + (statistics.rephases + 1) * options.rephase_interval;
+        }
 
-            if (clause_satisfied)
+        // Delete useless learned clauses periodically
+        if (statistics.conflicts >= next_reduce)
+        {
+            SATSolver::reduceDatabase();
+            next_reduce = statistics.conflicts + options.reduce_interval + statistics.reductions * options.reduce_increment;
+        }
+
+        // Substitute, subsume and strengthen the clauses periodically
+        if ((options.substitution || options.subsumption) && statistics.conflicts >= next_subsumption)
+        {
+            if (!SATSolver::inprocess())
             {
-                continue;
+                return unsatisfied;
             }
+            next_subsumption = statistics.conflicts + (statistics.inprocessing_rounds + 1) * options.subsumption_interval;
+            continue;
+        }
 
-            // If the clause is unit, assign the literal
-            if (unassigned_count == 1)
+        // Probe the roots of the binary implication graph periodically
+        if (options.probing && statistics.conflicts >= next_probe)
+        {
+            if (!SATSolver::probeLiterals())
             {
-                literals[unassigned_literal_index].literal = abs(unassigned_literal);
-                literals[unassigned_literal_index].value = unassigned_literal > 0 ? 1 : 0;
-                literals[unassigned_literal_index].decision_level = decision_level;
-                literals[unassigned_literal_index].antecedent_clause = i;
-                assigned_literal_count++;
-
-                unit_clause_found = true;
+                return unsatisfied;
             }
-            // If the clause is empty, return unsatisfied
-            else if (unassigned_count == 0)
+            next_probe = statistics.conflicts + (statistics.probing_rounds + 1) * options.probing_interval;
+            continue;
+        }
+
+        // Shorten the clauses by propagation periodically
+        if (options.vivification && statistics.conflicts >= next_vivify)
+        {
+            if (!SATSolver::vivifyClauses())
             {
-                antecedent_clause = i;
-                return SAT::unsatisfied;
+                return unsatisfied;
             }
+            next_vivify = statistics.conflicts + (statistics.vivification_rounds + 1) * options.vivification_interval;
+            continue;
         }
-    }
-    return SAT::normal;
-}
 
-int SATSolver::chooseLiteral()
-{
-    // Basic strategy
-    if (strategy == 0)
-    {
-        // Choose the first unassigned literal
-        for (auto &literal : literals)
+        // Drop the clauses satisfied at decision level 0
+        SATSolver::simplifyDatabase();
+
+        // Decide the assumptions first, each at its own decision level; a
+        // true assumption gets an empty one and a false one ends the search
+        int literal = 0;
+        while (literal == 0 && SATSolver::decisionLevel() < assumptions.size())
         {
-            if (literal.value == -1)
+            int assumption = assumptions[SATSolver::decisionLevel()];
+            int value = SATSolver::literalValue(assumption);
+            if (value == 0)
+            {
+                failed_assumption = assumption;
+                return unsatisfied;
+            }
+            else if (value == 1)
+            {
+                SATSolver::newDecisionLevel();
+            }
+            else
             {
-                return literal.literal;
+                literal = assumption;
             }
         }
-    }
-    // VSIDS
-    else if (strategy == 1)
-    {
-        // Choose the literal with the highest score
-        double max_score = 0.0;
-        int max_score_literal = 0;
 
-        // Decay the scores of the literals
-        double decay_factor = 0.98;
+        // Otherwise, choose a literal
+        if (literal == 0)
+        {
+            literal = SATSolver::chooseLiteral();
+        }
 
-        for (auto &literal : literals)
+        // Open a new decision level and assign the newly chosen literal
+        SATSolver::newDecisionLevel();
+        statistics.decisions++;
+        SATSolver::assignLiteral(literal, CLAUSE_UNDEF);
+
+        while (true)
         {
-            if (literal.value == -1 && literal.score >= max_score)
+            conflict_clause = SATSolver::unitPropagation();
+
+            if (conflict_clause != CLAUSE_UNDEF)
             {
-                max_score = literal.score;
-                max_score_literal = literal.literal;
-            }
+                // If the decision level is 0, the formula is unsatisfied
+                if (SATSolver::decisionLevel() == 0)
+                {
+                    return unsatisfied;
+                }
 
-            // Decay the score of the literal
-            literal.score *= decay_factor;
+                // Otherwise, learn a clause and backtrack
+                statistics.conflicts++;
+                SATSolver::analyzeConflict(conflict_clause);
+            }
+            else
+            {
+                break;
+            }
         }
+    }
 
-        return max_score_literal;
+    // Every variable may be assigned before the last assumptions are
+    // decided, so they can still be false
+    for (int assumption : assumptions)
+    {
+        if (SATSolver::literalValue(assumption) == 0)
+        {
+            failed_assumption = assumption;
+            return unsatisfied;
+        }
     }
 
-    return 0;
+    return satisfied;
 }
 
-int SATSolver::analyzeConflict(int decision_level)
+bool SATSolver::solve()
 {
-    // Conflict clause is the antecedent clause
-    std::vector<int> conflict_clause = formula[antecedent_clause];
+    // The assumptions only hold for one call
+    std::vector<int> assumed;
+    assumed.swap(pending_assumptions);
+    return SATSolver::solveAssuming(assumed, -1) == satisfied;
+}
 
-    // Decision level of the conflict clause
-    int conflict_decision_level = decision_level;
+SAT SATSolver::solveAssuming(const std::vector<int> &assumptions, long long conflict_budget)
+{
+    // The removed variables come back before they are assumed, and the
+    // assumed ones are frozen so that inprocessing keeps them
+    for (int assumption : assumptions)
+    {
+        SATSolver::resizeVariables(abs(assumption));
+        if (eliminated[abs(assumption)])
+        {
+            SATSolver::restoreEliminated();
+        }
+    }
+    for (int assumption : assumptions)
+    {
+        SATSolver::freeze(abs(assumption));
+    }
 
-    // Number of literals assigned at the current decision level
-    int this_level_count = 0;
+    this->assumptions = assumptions;
+    conflict_limit = conflict_budget < 0 ? LLONG_MAX : statistics.conflicts + conflict_budget;
+    result = SATSolver::search();
 
-    // Resolver literal is the literal that is assigned at the current decision level
-    int resolver_literal = 0;
+    for (int assumption : assumptions)
+    {
+        SATSolver::melt(abs(assumption));
+    }
 
-    while (true)
+    // Only a conflict with the assumptions leaves the formula satisfiable
+    failed_core.clear();
+    if (result == unsatisfied && failed_assumption == 0)
+    {
+        empty_clause_found = true;
+    }
+    else if (result == unsatisfied)
+    {
+        SATSolver::analyzeFinal();
+    }
+    else if (result == satisfied)
     {
-        this_level_count = 0;
+        SATSolver::extendModel();
+    }
+
+    return result;
+}
 
-        for (int i = 0; i < conflict_clause.size(); i++)
+void SATSolver::analyzeFinal()
+{
+    // The false assumption failed, with the assumptions its negation was
+    // implied from; above decision level 0, every decision is an assumption
+    failed_core.push_back(failed_assumption);
+    if (levels[abs(failed_assumption)] > 0)
+    {
+        seen[abs(failed_assumption)] = 1;
+        for (int i = trail.size() - 1; i >= trail_lim[0]; i--)
         {
-            int literal = conflict_clause[i];
-            int index = SATSolver::get_literal_index(literal);
+            int literal = trail[i];
+            int variable = abs(literal);
+            if (!seen[variable])
+            {
+                continue;
+            }
+            seen[variable] = 0;
 
-            // If the literal is assigned at the current decision level, increment the count
-            if (literals[index].decision_level == conflict_decision_level)
+            if (reasons[variable] == CLAUSE_UNDEF)
             {
-                this_level_count++;
+                failed_core.push_back(literal);
+                continue;
             }
 
-            // If the literal is assigned at the current decision level
-            // and is unassigned, it is the resolver literal
-            if (literals[index].decision_level == conflict_decision_level && literals[index].antecedent_clause != -1)
+            // The first literal of a reason is the literal it implied
+            int reason_size;
+            int *reason = SATSolver::reasonLiterals(reasons[variable], literal, reason_size);
+            for (int k = 1; k < reason_size; k++)
             {
-                resolver_literal = literal;
+                if (levels[abs(reason[k])] > 0)
+                {
+                    seen[abs(reason[k])] = 1;
+                }
             }
         }
+    }
+
+    std::sort(failed_core.begin(), failed_core.end());
+}
 
-        // If there is only one literal assigned at the current decision level, break
-        if (this_level_count == 1)
+void SATSolver::restoreEliminated()
+{
+    // The removed clauses go back to the formula as original clauses, which
+    // makes every eliminated and substituted variable a plain one again
+    SATSolver::backtrack(0);
+    std::vector<int> removed;
+    removed.swap(extension_stack);
+    for (int variable = 1; variable <= variable_count; variable++)
+    {
+        if (eliminated[variable])
         {
-            break;
+            eliminated[variable] = 0;
+            order_heap.insert(variable);
         }
+    }
+    eliminated_count = 0;
 
-        // Conflict clause is the union of the antecedent clauses of the resolver literal
-        // and the conflict clause without the resolver literal
-        std::vector<int> first_clause = conflict_clause;
-        int resolver_index = SATSolver::get_literal_index(resolver_literal);
-        std::vector<int> second_clause = formula[literals[resolver_index].antecedent_clause];
-
-        first_clause.insert(first_clause.end(), second_clause.begin(), second_clause.end());
+    for (int i = removed.size() - 1; i >= 0;)
+    {
+        int size = removed[i];
+        SATSolver::addClause(&removed[i - size], size);
+        statistics.restored_clauses++;
+        i -= size + 1;
+    }
+}
 
-        for (int i = 0; i < first_clause.size(); i++)
+void SATSolver::extendModel()
+{
+    // The eliminated variables start false
+    model = values;
+    for (int variable = 1; variable <= variable_count; variable++)
+    {
+        if (model[variable] == -1)
         {
-            if (abs(first_clause[i]) == abs(resolver_literal))
-            {
-                first_clause.erase(first_clause.begin() + i);
-                i--;
-            }
+            model[variable] = 0;
         }
+    }
 
-        std::sort(first_clause.begin(), first_clause.end());
-        first_clause.erase(std::unique(first_clause.begin(), first_clause.end()), first_clause.end());
+    // Undo the eliminations in reverse order: the value of an eliminated
+    // variable is flipped whenever one of its removed clauses is falsified
+    for (int i = extension_stack.size() - 1; i >= 0;)
+    {
+        int size = extension_stack[i];
+        int *clause = &extension_stack[i - size];
+        i -= size + 1;
+
+        bool satisfied = false;
+        for (int k = 0; k < size && !satisfied; k++)
+        {
+            satisfied = model[abs(clause[k])] == (clause[k] > 0 ? 1 : 0);
+        }
 
-        conflict_clause = first_clause;
+        if (!satisfied)
+        {
+            model[abs(clause[0])] = clause[0] > 0 ? 1 : 0;
+        }
     }
+}
+
+void SATSolver::assume(int literal)
+{
+    pending_assumptions.push_back(literal);
+}
 
-    // Increment the score of each literal in the conflict clause
-    for (int& literal : conflict_clause)
+int SATSolver::value(int literal)
+{
+    int variable = abs(literal);
+    if (variable >= model.size())
     {
-        int index = SATSolver::get_literal_index(literal);
-        literals[index].score += 1.0;
+        return 0;
     }
+    return (model[variable] == 1) == (literal > 0) ? literal : -literal;
+}
 
-    formula.push_back(conflict_clause);
+bool SATSolver::failed(int literal)
+{
+    return std::binary_search(failed_core.begin(), failed_core.end(), literal);
+}
 
-    // Backtrack level is the decision level of the literal that is assigned
-    // at the current decision level and is unassigned
-    int backtrack_level = 0;
+void SATSolver::freeze(int variable)
+{
+    SATSolver::resizeVariables(variable);
+    frozen[variable]++;
+}
 
-    for (int i = 0; i < conflict_clause.size(); i++)
+void SATSolver::melt(int variable)
+{
+    if (variable <= variable_count && frozen[variable] > 0)
     {
-        int literal = conflict_clause[i];
-        int index = SATSolver::get_literal_index(literal);
-        if (literals[index].decision_level != conflict_decision_level && literals[index].decision_level > backtrack_level)
-        {
-            backtrack_level = literals[index].decision_level;
-        }
+        frozen[variable]--;
     }
+}
 
-    backtrack(conflict_clause, backtrack_level);
+void SATSolver::setTerminateCallback(int (*callback)(void *), void *data)
+{
+    terminate_callback = callback;
+    terminate_data = data;
+}
 
-    return backtrack_level;
+void SATSolver::setLearnCallback(void (*callback)(void *, int *), void *data, int max_size)
+{
+    learn_callback = callback;
+    learn_data = data;
+    learn_max_size = max_size;
 }
 
-void SATSolver::backtrack(std::vector<int> &conflict_clause, int &decision_level)
+SAT SATSolver::lookahead(std::vector<int> &cube, int &split_literal)
 {
-    for (auto &literal : literals)
+    split_literal = 0;
+    statistics.lookaheads++;
+    SATSolver::backtrack(0);
+    if (!SATSolver::prepareSearch())
     {
-        // If the literal is assigned at a higher decision level, unassign it
-        if (literal.decision_level > decision_level)
-        {
-            literal.value = -1;
-            literal.decision_level = -1;
-            literal.antecedent_clause = -1;
-            assigned_literal_count--;
-        }
+        return unsatisfied;
     }
-}
 
-bool SATSolver::solve()
-{
-    // Sort the formula by clause length
-    sort(formula.begin(), formula.end(), [](const std::vector<int> &a, const std::vector<int> &b)
-         { return a.size() < b.size(); });
+    // Lookahead assignments are not decisions of the search, so they must
+    // not change the saved phases
+    std::vector<signed char> phases = saved_phases;
+    long long start = statistics.propagations;
 
-    int decision_level = 0;
+    // Assign the cube, one decision level per literal
+    auto assumeLiteral = [&](int literal)
+    {
+        int value = SATSolver::literalValue(literal);
+        SATSolver::newDecisionLevel();
+        if (value == -1)
+        {
+            SATSolver::assignLiteral(literal, CLAUSE_UNDEF);
+            return SATSolver::unitPropagation() == CLAUSE_UNDEF;
+        }
+        return value == 1;
+    };
 
-    int result = SATSolver::unitPropagation(decision_level);
+    bool consistent = true;
+    for (int i = 0; i < cube.size() && consistent; i++)
+    {
+        consistent = assumeLiteral(cube[i]);
+    }
 
-    // If the formula is satisfied, return true
-    if (result == SAT::satisfied)
+    // The candidates are the free variables with the most watches on both
+    // of their literals
+    std::vector<std::pair<long long, int>> candidates;
+    for (int variable = 1; variable <= variable_count && consistent; variable++)
     {
-        return true;
+        if (values[variable] == -1 && !eliminated[variable])
+        {
+            long long positive = watches[SATSolver::watchIndex(variable)].size() + ternary_watches[SATSolver::watchIndex(variable)].size();
+            long long negative = watches[SATSolver::watchIndex(-variable)].size() + ternary_watches[SATSolver::watchIndex(-variable)].size();
+            long long score = (positive + 1) * (negative + 1);
+            candidates.push_back({-score, variable});
+        }
     }
+    int candidate_count = std::min((int)candidates.size(), options.lookahead_candidates);
+    std::partial_sort(candidates.begin(), candidates.begin() + candidate_count, candidates.end());
 
-    // If the formula is unsatisfied, return false
-    else if (result == SAT::unsatisfied)
+    // Propagate both literals of each candidate and keep the one that
+    // assigns the most on both sides; a failed literal extends the cube
+    // with its negation
+    std::vector<std::pair<long long, int>> scores;
+    for (int i = 0; i < candidate_count && consistent; i++)
     {
-        return false;
+        int variable = candidates[i].second;
+        if (values[variable] != -1)
+        {
+            continue;
+        }
+
+        int level = SATSolver::decisionLevel();
+        int counts[2];
+        bool failed[2];
+        for (int side = 0; side < 2; side++)
+        {
+            int size = trail.size();
+            failed[side] = !assumeLiteral(side == 0 ? variable : -variable);
+            counts[side] = trail.size() - size;
+            SATSolver::backtrack(level);
+        }
+
+        if (failed[0] || failed[1])
+        {
+            int implied = failed[0] ? -variable : variable;
+            cube.push_back(implied);
+            consistent = !(failed[0] && failed[1]) && assumeLiteral(implied);
+            continue;
+        }
+
+        scores.push_back({1024LL * counts[0] * counts[1] + counts[0] + counts[1], variable});
     }
 
-    // If the formula is normal, assign literals until the formula is satisfied or unsatisfied
-    while (literal_count != assigned_literal_count)
+    // A failed literal found later may have assigned the best candidates
+    long long best_score = -1;
+    for (auto &score : scores)
     {
-        // Choose a literal
-        int literal = SATSolver::chooseLiteral();
-        int index = SATSolver::get_literal_index(literal);
+        if (consistent && values[score.second] == -1 && score.first > best_score)
+        {
+            best_score = score.first;
+            split_literal = score.second;
+        }
+    }
 
-        // Increase the decision level and assign the newly chosen literal
-        decision_level++;
-        literals[index].value = literal > 0 ? 1 : 0;
-        literals[index].decision_level = decision_level;
-        assigned_literal_count++;
+    SATSolver::backtrack(0);
+    saved_phases = phases;
+    statistics.lookahead_propagations += statistics.propagations - start;
 
-        while (true)
+    // The split literal takes the phase chooseLiteral would give it
+    if (split_literal != 0)
+    {
+        int phase = saved_phases[split_literal];
+        if (options.target_phases && target_phases[split_literal] != -1)
         {
-            result = SATSolver::unitPropagation(decision_level);
+            phase = target_phases[split_literal];
+        }
+        split_literal = phase ? split_literal : -split_literal;
+    }
+    return consistent ? normal : unsatisfied;
+}
 
-            if (result == SAT::unsatisfied)
-            {
-                // If the decision level is 0, return false
-                if (decision_level == 0)
-                {
-                    return false;
-                }
+SAT SATSolver::getResult()
+{
+    return result;
+}
 
-                // Otherwise, backtrack
-                decision_level = SATSolver::analyzeConflict(decision_level);
-            }
-            else
-            {
-                break;
-            }
+void SATSolver::setTerminateFlag(const std::atomic<bool> *terminate_flag)
+{
+    this->terminate_flag = terminate_flag;
+}
+
+void SATSolver::setClauseExchange(ClauseExchange *exchange, int worker)
+{
+    this->exchange = exchange;
+    exchange_worker = worker;
+    share_lbd = options.share_lbd;
+    next_share_update = options.share_interval;
+    shared_exports = 0;
+    shared_hashes.assign(exchange != nullptr ? 1 << 16 : 0, 0);
+}
+
+void SATSolver::moveClausesToBase()
+{
+    if (arena.inBase(0))
+    {
+        return;
+    }
+
+    // Binary clauses only move to the watch lists, so they stay pending
+    std::shared_ptr<ClauseArena> base = std::make_shared<ClauseArena>();
+    base->reserve(arena.size() - arena.wasted());
+    int base_count = 0;
+    int j = 0;
+    for (int i = 0; i < clauses.size(); i++)
+    {
+        if (arena.deleted(clauses[i]))
+        {
+            continue;
+        }
+
+        Clause &clause = arena[clauses[i]];
+        if (clause.size() == 2)
+        {
+            pending_binaries.push_back(clause[0]);
+            pending_binaries.push_back(clause[1]);
+            continue;
         }
+
+        ClauseRef base_ref = base->allocate(clause.literals(), clause.size(), false);
+        (*base)[base_ref].base_index = base_count++;
+        clauses[j++] = base_ref;
     }
+    clauses.resize(j);
 
-    return true;
+    // No search has run, so the arena held nothing but the original clauses
+    arena = ClauseArena();
+    arena.setBase(base, base_count);
+}
+
+void SATSolver::shareBaseClauses(SATSolver &formula)
+{
+    // The clauses of the formula are already normalized, so they are
+    // taken as they are
+    SATSolver::resizeVariables(formula.variable_count);
+    empty_clause_found = empty_clause_found || formula.empty_clause_found;
+    arena.shareBase(formula.arena);
+    clauses = formula.clauses;
+    pending_binaries = formula.pending_binaries;
 }
 
 std::vector<std::pair<int, bool>> SATSolver::getAssignment()
 {
+    // Variables are visited in order, so the assignment is sorted by variable
     std::vector<std::pair<int, bool>> assignment;
-    for (auto &literal : literals)
+    assignment.reserve(variable_count);
+    for (int variable = 1; variable <= variable_count; variable++)
     {
-        std::pair<int, bool> literal_assignment;
-        literal_assignment.first = literal.literal;
-        literal_assignment.second = literal.value == 1 ? true : false;
-        std::cout << literal.literal << " " << literal.value << "\n";
-        assignment.push_back(literal_assignment);
+        std::pair<int, bool> variable_assignment;
+        variable_assignment.first = variable;
+        variable_assignment.second = variable < model.size() && model[variable] == 1 ? true : false;
+        assignment.push_back(variable_assignment);
     }
-    std::sort(assignment.begin(), assignment.end(), [](const std::pair<int, bool> &a, const std::pair<int, bool> &b)
-              { return a.first < b.first; });
     return assignment;
-}
\ No newline at end of file
+}
+
+SATSolverStatistics SATSolver::getStatistics()
+{
+    return statistics;
+}
+
+void SATSolver::printStatistics(std::ostream &out)
+{
+    // Lines start with 'c' like DIMACS comments
+    out << "c decisions:                 " << statistics.decisions << "\n";
+    out << "c propagations:              " << statistics.propagations << "\n";
+    out << "c conflicts:                 " << statistics.conflicts << "\n";
+    out << "c learned literals:          " << statistics.learned_literals << "\n";
+    out << "c minimized literals:        " << statistics.minimized_literals << "\n";
+    out << "c binary minimized literals: " << statistics.binary_minimized_literals << "\n";
+    out << "c reductions:                " << statistics.reductions << " (first after " << options.reduce_interval << " conflicts, +" << options.reduce_increment << " each)\n";
+    out << "c deleted learned clauses:   " << statistics.deleted_clauses << "\n";
+    out << "c promoted learned clauses:  " << statistics.promoted_clauses << "\n";
+    out << "c restarts:                  " << statistics.restarts << "\n";
+    out << "c blocked restarts:          " << statistics.blocked_restarts << "\n";
+    out << "c reused decision levels:    " << statistics.reused_levels << "\n";
+    out << "c rephases:                  " << statistics.rephases << "\n";
+    out << "c walk flips:                " << statistics.walk_flips << "\n";
+    out << "c eliminated variables:      " << statistics.eliminated_variables << "\n";
+    out << "c eliminated clauses:        " << statistics.eliminated_clauses << "\n";
+    out << "c resolvents:                " << statistics.resolvents << "\n";
+    out << "c inprocessing rounds:       " << statistics.inprocessing_rounds << "\n";
+    out << "c subsumption rounds:        " << statistics.subsumption_rounds << "\n";
+    out << "c subsumed clauses:          " << statistics.subsumed_clauses << "\n";
+    out << "c strengthened clauses:      " << statistics.strengthened_clauses << "\n";
+    out << "c substituted variables:     " << statistics.substituted_variables << "\n";
+    out << "c probing rounds:            " << statistics.probing_rounds << "\n";
+    out << "c probed literals:           " << statistics.probed_literals << "\n";
+    out << "c probing propagations:      " << statistics.probing_propagations << "\n";
+    out << "c failed literals:           " << statistics.failed_literals << "\n";
+    out << "c implied units:             " << statistics.implied_units << "\n";
+    out << "c hyper binary resolvents:   " << statistics.hyper_binary_resolvents << "\n";
+    out << "c vivification rounds:       " << statistics.vivification_rounds << "\n";
+    out << "c vivified clauses:          " << statistics.vivified_clauses << "\n";
+    out << "c vivification propagations: " << statistics.vivification_propagations << "\n";
+    out << "c vivified literals:         " << statistics.vivified_literals << "\n";
+    out << "c vivification removed:      " << statistics.vivification_removed_clauses << "\n";
+    out << "c exported clauses:          " << statistics.exported_clauses << "\n";
+    out << "c imported clauses:          " << statistics.imported_clauses << "\n";
+    out << "c imported clauses used:     " << statistics.imported_clauses_used << "\n";
+    out << "c duplicate shared clauses:  " << statistics.duplicate_shared_clauses << "\n";
+    out << "c lost shared clauses:       " << statistics.lost_shared_clauses << "\n";
+    out << "c lookaheads:                " << statistics.lookaheads << "\n";
+    out << "c lookahead propagations:    " << statistics.lookahead_propagations << "\n";
+    out << "c restored clauses:          " << statistics.restored_clauses << "\n";
+
+    // Count the live clauses of each tier, skipping stale and duplicate entries
+    const char *tier_names[] = {"core", "tier2", "local"};
+    int tier_limits[] = {options.core_lbd, options.tier2_lbd, -1};
+    for (int tier = ClauseTier::core; tier <= ClauseTier::local; tier++)
+    {
+        std::vector<ClauseRef> tier_learnts;
+        for (ClauseRef clause_ref : learnts[tier])
+        {
+            if (!arena[clause_ref].deleted && arena[clause_ref].tier == tier)
+            {
+                tier_learnts.push_back(clause_ref);
+            }
+        }
+        std::sort(tier_learnts.begin(), tier_learnts.end());
+        int count = std::unique(tier_learnts.begin(), tier_learnts.end()) - tier_learnts.begin();
+
+        out << "c " << tier_names[tier] << " learned clauses:" << std::string(10 - std::string(tier_names[tier]).size(), ' ') << count;
+        if (tier_limits[tier] != -1)
+        {
+            out << " (LBD <= " << tier_limits[tier] << ")";
+        }
+        out << "\n";
+    }
+}
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <vector>
+
+/*
+ * An indexed binary max-heap of variables ordered by activity
+ *
+ * The heap does not own the activities; it keeps a reference to the
+ * solver's activity array and must be told when an activity increases.
+ *
+ * Member functions:
+ *   bool empty()
+ *       Checks whether the heap is empty
+ *       @return true if there are no variables in the heap
+ *
+ *   bool contains(int variable)
+ *       Checks whether the given variable is in the heap
+ *       @param variable The variable
+ *       @return true if the variable is in the heap
+ *
+ *   void resize(int variable_count)
+ *       Makes room for the variables 1..variable_count
+ *       @param variable_count The number of variables
+ *
+ *   void insert(int variable)
+ *       Inserts the given variable if it is not in the heap yet
+ *       @param variable The variable
+ *
+ *   void increase(int variable)
+ *       Restores the heap order after the activity of the given variable
+ *       has increased
+ *       @param variable The variable
+ *
+ *   int top()
+ *       Gets the variable with the highest activity without removing it
+ *       @return The variable
+ *
+ *   int removeMax()
+ *       Removes the variable with the highest activity
+ *       @return The removed variable
+ *
+ * Data members:
+ *   const std::vector<double> &activity
+ *       The activity of each variable, indexed by variable
+ *
+ *   std::vector<int> heap
+ *       The variables in heap order
+ *
+ *   std::vector<int> positions
+ *       The position of each variable in the heap, indexed by variable
+ *       -1 if the variable is not in the heap
+ */
+
+class VariableHeap
+{
+private:
+    // Member functions
+    void percolateUp(int);
+    void percolateDown(int);
+
+    // Data members
+    const std::vector<double> &activity;
+    std::vector<int> heap;
+    std::vector<int> positions;
+
+public:
+    // Constructors
+    VariableHeap(const std::vector<double> &);
+
+    // Member functions
+    bool empty();
+    bool contains(int);
+    void resize(int);
+    void insert(int);
+    void increase(int);
+    int top();
+    int removeMax();
+};
+
+VariableHeap::VariableHeap(const std::vector<double> &activity) : activity(activity)
+{
+}
+
+bool VariableHeap::empty()
+{
+    return heap.empty();
+}
+
+bool VariableHeap::contains(int variable)
+{
+    return variable < positions.size() && positions[variable] != -1;
+}
+
+void VariableHeap::resize(int variable_count)
+{
+    if (positions.size() < variable_count + 1)
+    {
+        positions.resize(variable_count + 1, -1);
+    }
+}
+
+void VariableHeap::insert(int variable)
+{
+    if (VariableHeap::contains(variable))
+    {
+        return;
+    }
+
+    positions[variable] = heap.size();
+    heap.push_back(variable);
+    VariableHeap::percolateUp(positions[variable]);
+}
+
+void VariableHeap::increase(int variable)
+{
+    if (VariableHeap::contains(variable))
+    {
+        VariableHeap::percolateUp(positions[variable]);
+    }
+}
+
+int VariableHeap::top()
+{
+    return heap[0];
+}
+
+int VariableHeap::removeMax()
+{
+    int variable = heap[0];
+
+    // Move the last variable to the root and sift it down
+    heap[0] = heap.back();
+    positions[heap[0]] = 0;
+    positions[variable] = -1;
+    heap.pop_back();
+
+    if (heap.size() > 1)
+    {
+        VariableHeap::percolateDown(0);
+    }
+
+    return variable;
+}
+
+void VariableHeap::percolateUp(int position)
+{
+    int variable = heap[position];
+
+    // Move parents with a lower activity down until the variable fits
+    while (position > 0)
+    {
+        int parent = (position - 1) / 2;
+        if (activity[heap[parent]] >= activity[variable])
+        {
+            break;
+        }
+
+        heap[position] = heap[parent];
+        positions[heap[position]] = position;
+        position = parent;
+    }
+
+    heap[position] = variable;
+    positions[variable] = position;
+}
+
+void VariableHeap::percolateDown(int position)
+{
+    int variable = heap[position];
+
+    // Move children with a higher activity up until the variable fits
+    while (2 * position + 1 < heap.size())
+    {
+        int child = 2 * position + 1;
+        if (child + 1 < heap.size() && activity[heap[child + 1]] > activity[heap[child]])
+        {
+            child++;
+        }
+
+        if (activity[heap[child]] <= activity[variable])
+        {
+            break;
+        }
+
+        heap[position] = heap[child];
+        positions[heap[position]] = position;
+        position = child;
+    }
+
+    heap[position] = variable;
+    positions[variable] = position;
+}
@@ -0,0 +1,247 @@
+#pragma once
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+/*
+ * A ProbSAT-style local search used to derive decision phases
+ *
+ * Starting from the given phases, the walker repeatedly picks a random
+ * falsified clause and flips one of its variables, preferring variables
+ * that falsify few other clauses. The assignment with the fewest falsified
+ * clauses seen is handed back as the new phases.
+ *
+ * Member functions:
+ *   void addClause(const int *literals, int size)
+ *       Adds a clause to walk on
+ *       @param literals The literals of the clause
+ *       @param size The number of literals
+ *
+ *   int walk(std::vector<signed char> &phases, long long max_flips)
+ *       Runs the local search
+ *       @param phases The starting phase of each variable (1 or 0), indexed
+ *                     by variable; replaced by the best assignment found
+ *       @param max_flips The largest number of flips
+ *       @return The number of clauses falsified by the best assignment
+ *
+ *   long long getFlips()
+ *       Gets the number of flips made by the last walk
+ *       @return The number of flips
+ *
+ * Data members:
+ *   int variable_count
+ *       The number of variables
+ *
+ *   std::vector<int> literals
+ *       The literals of every clause, one clause after the other
+ *
+ *   std::vector<int> clause_starts
+ *       The position of each clause in literals, plus the end position
+ *
+ *   std::vector<std::vector<int>> occurrences
+ *       The clauses containing each literal, indexed like watch lists
+ *
+ *   std::vector<int> true_counts
+ *       The number of true literals of each clause
+ *
+ *   std::vector<int> falsified, falsified_positions
+ *       The falsified clauses, and the position of each clause in that
+ *       list (-1 if it is satisfied)
+ *
+ *   std::vector<double> break_weights
+ *       The weight of a flip that falsifies the given number of clauses
+ *
+ *   std::mt19937 random_generator
+ *       The source of randomness
+ *
+ *   long long flips
+ *       The number of flips made by the last walk
+ */
+
+class Walker
+{
+private:
+    // Member functions
+    int occurrenceIndex(int);
+    void makeClause(int);
+    void breakClause(int);
+    void flip(int, std::vector<signed char> &);
+    int breakCount(int, std::vector<signed char> &);
+
+    // Data members
+    int variable_count;
+    std::vector<int> literals;
+    std::vector<int> clause_starts;
+    std::vector<std::vector<int>> occurrences;
+    std::vector<int> true_counts;
+    std::vector<int> falsified;
+    std::vector<int> falsified_positions;
+    std::vector<double> break_weights;
+    std::mt19937 random_generator;
+    long long flips;
+
+public:
+    // Constructors
+    Walker(int, unsigned);
+
+    // Member functions
+    void addClause(const int *, int);
+    int walk(std::vector<signed char> &, long long);
+    long long getFlips();
+};
+
+Walker::Walker(int variable_count, unsigned seed) : random_generator(seed)
+{
+    this->variable_count = variable_count;
+    this->flips = 0;
+    clause_starts.push_back(0);
+    occurrences.resize(2 * variable_count + 2);
+
+    // ProbSAT's exponential break weights with base 2.5
+    for (int breaks = 0; breaks < 64; breaks++)
+    {
+        break_weights.push_back(std::pow(2.5, -breaks));
+    }
+}
+
+int Walker::occurrenceIndex(int literal)
+{
+    return literal > 0 ? 2 * literal : 2 * (-literal) + 1;
+}
+
+void Walker::addClause(const int *clause_literals, int size)
+{
+    int clause = clause_starts.size() - 1;
+    for (int i = 0; i < size; i++)
+    {
+        literals.push_back(clause_literals[i]);
+        occurrences[Walker::occurrenceIndex(clause_literals[i])].push_back(clause);
+    }
+    clause_starts.push_back(literals.size());
+}
+
+void Walker::makeClause(int clause)
+{
+    // Swap the last falsified clause into the hole
+    int position = falsified_positions[clause];
+    int last = falsified.back();
+    falsified[position] = last;
+    falsified_positions[last] = position;
+    falsified.pop_back();
+    falsified_positions[clause] = -1;
+}
+
+void Walker::breakClause(int clause)
+{
+    falsified_positions[clause] = falsified.size();
+    falsified.push_back(clause);
+}
+
+void Walker::flip(int variable, std::vector<signed char> &phases)
+{
+    phases[variable] = !phases[variable];
+    int true_literal = phases[variable] ? variable : -variable;
+    flips++;
+
+    for (int clause : occurrences[Walker::occurrenceIndex(true_literal)])
+    {
+        if (true_counts[clause]++ == 0)
+        {
+            Walker::makeClause(clause);
+        }
+    }
+
+    for (int clause : occurrences[Walker::occurrenceIndex(-true_literal)])
+    {
+        if (--true_counts[clause] == 0)
+        {
+            Walker::breakClause(clause);
+        }
+    }
+}
+
+int Walker::breakCount(int variable, std::vector<signed char> &phases)
+{
+    // Flipping the variable falsifies the clauses where it is the only true literal
+    int true_literal = phases[variable] ? variable : -variable;
+    int breaks = 0;
+    for (int clause : occurrences[Walker::occurrenceIndex(true_literal)])
+    {
+        if (true_counts[clause] == 1)
+        {
+            breaks++;
+        }
+    }
+    return breaks;
+}
+
+int Walker::walk(std::vector<signed char> &phases, long long max_flips)
+{
+    int clause_count = clause_starts.size() - 1;
+    std::vector<signed char> current = phases;
+    flips = 0;
+
+    // Count the true literals of every clause under the starting phases
+    true_counts.assign(clause_count, 0);
+    falsified.clear();
+    falsified_positions.assign(clause_count, -1);
+    for (int clause = 0; clause < clause_count; clause++)
+    {
+        for (int i = clause_starts[clause]; i < clause_starts[clause + 1]; i++)
+        {
+            int literal = literals[i];
+            if ((literal > 0) == (current[abs(literal)] == 1))
+            {
+                true_counts[clause]++;
+            }
+        }
+
+        if (true_counts[clause] == 0)
+        {
+            Walker::breakClause(clause);
+        }
+    }
+
+    int best_falsified = falsified.size();
+    std::vector<double> weights;
+
+    while (!falsified.empty() && flips < max_flips)
+    {
+        // Pick a random falsified clause and one of its variables, weighted
+        // by how few clauses flipping it would falsify
+        int clause = falsified[random_generator() % falsified.size()];
+        weights.clear();
+        double total = 0;
+        for (int i = clause_starts[clause]; i < clause_starts[clause + 1]; i++)
+        {
+            int breaks = Walker::breakCount(abs(literals[i]), current);
+            double weight = break_weights[breaks < 64 ? breaks : 63];
+            weights.push_back(weight);
+            total += weight;
+        }
+
+        double threshold = std::uniform_real_distribution<double>(0, total)(random_generator);
+        int chosen = clause_starts[clause];
+        for (int i = 0; i < weights.size() - 1 && threshold >= weights[i]; i++)
+        {
+            threshold -= weights[i];
+            chosen++;
+        }
+
+        Walker::flip(abs(literals[chosen]), current);
+
+        if (falsified.size() < best_falsified)
+        {
+            best_falsified = falsified.size();
+            phases = current;
+        }
+    }
+
+    return best_falsified;
+}
+
+long long Walker::getFlips()
+{
+    return flips;
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstdint>
+#include "clause_arena.h"
+
+/*
+ * The clause reference of the watchers of binary clauses
+ *
+ * Binary clauses are not stored in the arena: both of their literals are
+ * watched, and each watcher keeps the other literal as its blocker.
+ *   BINARY_ORIGINAL: a binary clause of the input formula
+ *   BINARY_LEARNT: a binary clause learned from a conflict
+ */
+
+const ClauseRef BINARY_ORIGINAL = UINT32_MAX - 1;
+
+const ClauseRef BINARY_LEARNT = UINT32_MAX - 2;
+
+/*
+ * An entry of a watch list
+ *
+ * The blocker is a literal of the clause other than the watched one. If it
+ * is true, the clause is satisfied and propagation skips it without reading
+ * the arena. For a binary clause, the blocker is the other literal.
+ *
+ * Member functions:
+ *   bool binary()
+ *       Checks whether the watched clause is an implicit binary clause
+ *       @return true if the clause is binary
+ *
+ * Data members:
+ *   int blocker
+ *       A literal of the clause other than the watched one
+ *
+ *   ClauseRef clause_ref
+ *       The reference of the clause, or BINARY_ORIGINAL or BINARY_LEARNT
+ */
+
+struct Watcher
+{
+    int blocker;
+    ClauseRef clause_ref;
+
+    bool binary()
+    {
+        return clause_ref == BINARY_ORIGINAL || clause_ref == BINARY_LEARNT;
+    }
+};
+
+/*
+ * An entry of a ternary watch list
+ *
+ * A clause of three literals is watched by all of them, and each watcher
+ * keeps the two other literals. The literals of the clause never change
+ * while it is watched, so the watchers never move, and propagation decides
+ * whether the clause is satisfied, unit or conflicting without reading the
+ * arena.
+ *
+ * Data members:
+ *   int first, second
+ *       The two literals of the clause other than the watched one
+ *
+ *   ClauseRef clause_ref
+ *       The reference of the clause
+ */
+
+struct TernaryWatcher
+{
+    int first;
+    int second;
+    ClauseRef clause_ref;
+};
+
+/*
+ * Reasons made of binary clauses
+ *
+ * A literal implied by a binary clause has no clause reference, so its
+ * reason is the other literal of the clause tagged with BINARY_REASON.
+ * Arena references stay below BINARY_REASON, which caps the arena at
+ * CLAUSE_ARENA_CAPACITY words.
+ */
+
+const ClauseRef BINARY_REASON = 0x80000000u;
+
+static_assert(BINARY_REASON == CLAUSE_ARENA_CAPACITY, "arena references must not reach the binary reason tag");
+
+/*
+ * Encodes the other literal of a binary clause as a reason
+ *
+ * @param literal The other literal of the binary clause
+ * @return The reason
+ */
+
+ClauseRef binaryReason(int literal)
+{
+    return BINARY_REASON | (literal > 0 ? 2 * literal : 2 * (-literal) + 1);
+}
+
+/*
+ * Checks whether a reason is made of a binary clause
+ *
+ * @param reason The reason
+ * @return true if the reason was built by binaryReason
+ */
+
+bool isBinaryReason(ClauseRef reason)
+{
+    return reason != CLAUSE_UNDEF && (reason & BINARY_REASON) != 0;
+}
+
+/*
+ * Decodes the other literal of a binary reason
+ *
+ * @param reason A reason built by binaryReason
+ * @return The other literal of the binary clause
+ */
+
+int binaryReasonLiteral(ClauseRef reason)
+{
+    uint32_t code = reason & ~BINARY_REASON;
+    return code & 1 ? -(int)(code >> 1) : (int)(code >> 1);
+}